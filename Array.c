@@ -3,6 +3,8 @@
 #include "Object.h"
 #include "String.h"
 #include "Int.h"
+#include "Float.h"
+#include "Dict.h"
 #include "Boolean.h"
 #include "ByteCode.h"
 #include "Memory.h"
@@ -13,11 +15,11 @@ struct ArrayIterator;
 extern struct ArrayIterator* new_ArrayIterator(Array* array);
 extern void ArrayIterator_init_class();
 
-#define capacity_increment 16
+#define min_capacity 16
 
 Class Array_class;
 
-Array empty_array = { &Array_class, 0, 0, NULL };
+Array empty_array = { &Array_class, 0, 0, NULL, 0 };
 
 
 Array* new_Array()
@@ -26,10 +28,39 @@ Array* new_Array()
 	self->class_ = &Array_class;
 	self->size = self->capacity = 0;
 	self->items = NULL;
+	self->front = 0;
 	return self;
 }
 
 
+static void Array_reallocate(Array* self, size_t front, size_t capacity)
+{
+	// Moves the items to a new block, with "front" free slots before them.
+	// Always allocating a new block (instead of reallocating) is what lets
+	// slices and popped-from-the-front Arrays have "items" inside a block.
+	Object** block = (Object**) alloc_mem((front + capacity) * sizeof(Object*));
+	if (self->size > 0)
+		memcpy(block + front, self->items, self->size * sizeof(Object*));
+	self->items = block + front;
+	self->front = front;
+	self->capacity = capacity;
+	self->is_slice = false;
+}
+
+
+static void Array_grow(Array* self, size_t needed_size)
+{
+	// Grow geometrically, so a run of appends (or of append/pop-front pairs) is
+	// amortized O(1).
+	size_t new_capacity = self->capacity * 2;
+	if (new_capacity < needed_size)
+		new_capacity = needed_size;
+	if (new_capacity < min_capacity)
+		new_capacity = min_capacity;
+	Array_reallocate(self, 0, new_capacity);
+}
+
+
 Object* Array_at(struct Array* self, size_t index)
 {
 	if (index >= self->size)
@@ -41,16 +72,11 @@ Object* Array_at(struct Array* self, size_t index)
 Object* Array_set_at(struct Array* self, size_t index, Object* value)
 {
 	if (index >= self->size) {
-		if (index >= self->capacity) {
-			size_t needed_size = index + 1;
-			size_t old_capacity = self->capacity;
-			self->capacity = needed_size + capacity_increment - (needed_size % capacity_increment);
-			if (self->items) {
-				self->items = (Object**) realloc_mem(self->items, self->capacity * sizeof(Object*));
-				memset(self->items + old_capacity, 0, (self->capacity - old_capacity) * sizeof(Object*));
-				}
-			else
-				self->items = (Object**) alloc_mem(self->capacity * sizeof(Object*));
+		if (index >= self->capacity)
+			Array_grow(self, index + 1);
+		else if (index > self->size) {
+			// Clear out anything left there by pop_back().
+			memset(self->items + self->size, 0, (index - self->size) * sizeof(Object*));
 			}
 		self->size = index + 1;
 		}
@@ -67,6 +93,24 @@ Object* Array_append(struct Array* self, Object* value)
 }
 
 
+void Array_reserve(Array* self, size_t capacity)
+{
+	if (capacity > self->capacity)
+		Array_reallocate(self, 0, capacity);
+}
+
+
+void Array_extend(Array* self, Array* other)
+{
+	size_t other_size = other->size;
+	if (self->size + other_size > self->capacity)
+		Array_grow(self, self->size + other_size);
+	// "other" might be "self", so get its items after growing.
+	memcpy(self->items + self->size, other->items, other_size * sizeof(Object*));
+	self->size += other_size;
+}
+
+
 void Array_append_strings(Array* self, Object* value)
 {
 	declare_static_string(string_string, "string");
@@ -76,9 +120,11 @@ void Array_append_strings(Array* self, Object* value)
 	if (value->class_ == &Array_class) {
 		// Splice in the array.
 		Array* other = (Array*) value;
+		if (self->size + other->size > self->capacity)
+			Array_grow(self, self->size + other->size);
 		for (int i = 0; i < other->size; ++i) {
 			Object* item = other->items[i];
-			if (item->class_ != &String_class)
+			if (item == NULL || item->class_ != &String_class)
 				item = call_object(item, &string_string, NULL);
 			Array_append(self, item);
 			}
@@ -103,6 +149,47 @@ Object* Array_pop_back(Array* self)
 }
 
 
+Object* Array_pop_front(Array* self)
+{
+	if (self->size == 0)
+		return NULL;
+
+	Object* item = self->items[0];
+	self->items += 1;
+	self->size -= 1;
+	self->capacity -= 1;
+	if (self->is_slice) {
+		// The slot we just left belongs to the original Array.
+		return item;
+		}
+	self->front += 1;
+	if (self->size == 0) {
+		// Empty; start over at the beginning of the block.
+		self->items -= self->front;
+		self->capacity += self->front;
+		self->front = 0;
+		}
+	return item;
+}
+
+
+void Array_push_front(Array* self, Object* value)
+{
+	if (self->front == 0) {
+		// Leave as much room in front as there are items, so a run of
+		// push_front()s is amortized O(1).
+		size_t front = (self->size > min_capacity ? self->size : min_capacity);
+		size_t capacity = (self->capacity > self->size ? self->capacity : self->size);
+		Array_reallocate(self, front, capacity);
+		}
+	self->items -= 1;
+	self->front -= 1;
+	self->capacity += 1;
+	self->size += 1;
+	self->items[0] = value;
+}
+
+
 Object* Array_back(Array* self)
 {
 	if (self->size == 0)
@@ -119,8 +206,9 @@ Array* Array_copy(Array* self)
 	copy->size = self->size;
 	copy->capacity = self->capacity;
 	copy->items = NULL;
+	copy->front = 0;
 	if (self->items) {
-		copy->items = (Object**) alloc_mem(self->capacity);
+		copy->items = (Object**) alloc_mem(self->capacity * sizeof(Object*));
 		memcpy(copy->items, self->items, self->size * sizeof(Object*));
 		}
 	return copy;
@@ -150,7 +238,7 @@ String* Array_join(Array* self, String* joiner)
 		total_size += (self->size - 1) * joiner->size;
 
 	// Do the join.
-	char* joined = alloc_mem(total_size);
+	char* joined = alloc_mem(total_size + 1);
 	char* out = joined;
 	bool need_joiner = false;
 	Object** next_stringized_item = stringized_items->items;
@@ -171,23 +259,26 @@ String* Array_join(Array* self, String* joiner)
 		}
 
 	// Return the string.
-	return new_static_String(joined, total_size);
+	*out = 0;
+	String* result = new_static_String(joined, total_size);
+	result->is_c_str = true;
+	return result;
 }
 
 
-static Object* Array_size_builtin(Object* super, Object** args)
+Object* Array_size_builtin(Object* super, Object** args)
 {
 	Array* self = (Array*) super;
 	return (Object*) new_Int(self->size);
 }
 
-static Object* Array_is_empty_builtin(Object* super, Object** args)
+Object* Array_is_empty_builtin(Object* super, Object** args)
 {
 	Array* self = (Array*) super;
 	return make_bool(self->size == 0);
 }
 
-static Object* Array_string_builtin(Object* super, Object** args)
+Object* Array_string_builtin(Object* super, Object** args)
 {
 	Array* self = (Array*) super;
 	if (self->size == 0)
@@ -200,7 +291,7 @@ static Object* Array_string_builtin(Object* super, Object** args)
 	return (Object*) Array_join(capped, new_c_static_String(" "));
 }
 
-static Object* Array_at_builtin(Object* super, Object** args)
+Object* Array_at_builtin(Object* super, Object** args)
 {
 	Array* self = (Array*) super;
 	int index = Int_enforce(args[0], "Array.[]");
@@ -209,7 +300,7 @@ static Object* Array_at_builtin(Object* super, Object** args)
 	return Array_at(self, index);
 }
 
-static Object* Array_at_set_builtin(Object* super, Object** args)
+Object* Array_at_set_builtin(Object* super, Object** args)
 {
 	Array* self = (Array*) super;
 	int index = Int_enforce(args[0], "Array.[]=");
@@ -223,14 +314,40 @@ static Object* Array_at_set_builtin(Object* super, Object** args)
 	return Array_set_at(self, index, args[1]);
 }
 
-static Object* Array_append_builtin(Object* super, Object** args)
+Object* Array_append_builtin(Object* super, Object** args)
 {
 	Array* self = (Array*) super;
 	Array_append(self, args[0]);
 	return args[0];
 }
 
-static Object* Array_plus_builtin(Object* super, Object** args)
+Object* Array_reserve_builtin(Object* super, Object** args)
+{
+	int capacity = Int_enforce(args[0], "Array.reserve");
+	if (capacity > 0)
+		Array_reserve((Array*) super, capacity);
+	return super;
+}
+
+Object* Array_extend_builtin(Object* super, Object** args)
+{
+	Array* self = (Array*) super;
+	Object* other = args[0];
+	if (other && other->class_ == &Array_class)
+		Array_extend(self, (Array*) other);
+	else if (other) {
+		Object* it = call_object(other, &iterator_string, NULL);
+		while (true) {
+			Object* item = call_object(it, &next_string, NULL);
+			if (item == NULL)
+				break;
+			Array_append(self, item);
+			}
+		}
+	return super;
+}
+
+Object* Array_plus_builtin(Object* super, Object** args)
 {
 	Array* self = (Array*) super;
 	Array* other = (Array*) args[0];
@@ -248,13 +365,13 @@ static Object* Array_plus_builtin(Object* super, Object** args)
 	return (Object*) result;
 }
 
-static Object* Array_iterator_builtin(Object* super, Object** args)
+Object* Array_iterator_builtin(Object* super, Object** args)
 {
 	Array* self = (Array*) super;
 	return (Object*) new_ArrayIterator(self);
 }
 
-static Object* Array_join_builtin(Object* super, Object** args)
+Object* Array_join_builtin(Object* super, Object** args)
 {
 	Array* self = (Array*) super;
 	String* joiner = (String*) args[0];
@@ -263,34 +380,33 @@ static Object* Array_join_builtin(Object* super, Object** args)
 	return (Object*) Array_join(self, joiner);
 }
 
-static Object* Array_pop_back_builtin(Object* super, Object** args)
+Object* Array_pop_back_builtin(Object* super, Object** args)
 {
 	return Array_pop_back((Array*) super);
 }
 
-static Object* Array_pop_front_builtin(Object* super, Object** args)
+Object* Array_pop_front_builtin(Object* super, Object** args)
 {
-	Array* self = (Array*) super;
-	if (self->size == 0)
-		return NULL;
-	Object* item = self->items[0];
-	self->items += 1;
-	self->size -= 1;
-	self->capacity -= 1;
-	return item;
+	return Array_pop_front((Array*) super);
+}
+
+Object* Array_push_front_builtin(Object* super, Object** args)
+{
+	Array_push_front((Array*) super, args[0]);
+	return args[0];
 }
 
-static Object* Array_back_builtin(Object* super, Object** args)
+Object* Array_back_builtin(Object* super, Object** args)
 {
 	return Array_back((Array*) super);
 }
 
-static Object* Array_copy_builtin(Object* super, Object** args)
+Object* Array_copy_builtin(Object* super, Object** args)
 {
 	return (Object*) Array_copy((Array*) super);
 }
 
-static Object* Array_slice_builtin(Object* super, Object** args)
+Object* Array_slice_builtin(Object* super, Object** args)
 {
 	Array* self = (Array*) super;
 	int start = args[0] ? Int_enforce(args[0], "Array.slice") : 0;
@@ -313,12 +429,128 @@ static Object* Array_slice_builtin(Object* super, Object** args)
 	slice->class_ = &Array_class;
 	slice->size = slice->capacity = end - start;
 	slice->items = self->items + start;
+	slice->is_slice = true;
 	return (Object*) slice;
 }
 
 declare_static_string(equals_string, "==");
+declare_static_string(less_than_string, "<");
 
-static Object* Array_contains_builtin(Object* super, Object** args)
+
+typedef struct SortItem {
+	Object* key;
+	Object* item;
+	} SortItem;
+
+typedef enum {
+	SortInts, SortNumbers, SortStrings, SortGeneric,
+	} SortKind;
+
+static bool sort_less(SortKind kind, Object* a, Object* b)
+{
+	switch (kind) {
+		case SortInts:
+			return Int_value(a) < Int_value(b);
+		case SortNumbers:
+			{
+			double a_value = (a->class_ == &Int_class ? Int_value(a) : Float_value(a));
+			double b_value = (b->class_ == &Int_class ? Int_value(b) : Float_value(b));
+			return a_value < b_value;
+			}
+		case SortStrings:
+			return String_cmp((String*) a, (String*) b) < 0;
+		case SortGeneric:
+			break;
+		}
+	Object* items[] = { b };
+	Array args_array = { &Array_class, 1, 1, items };
+	if (a == NULL)
+		Error("Can't sort a nil.");
+	return IS_TRUTHY(call_object(a, &less_than_string, &args_array));
+}
+
+static void merge_sort(SortItem* items, SortItem* scratch, size_t size, SortKind kind, bool reverse)
+{
+	// Stable: an item only moves ahead of an earlier one if it's strictly less.
+	// With "reverse", that's strictly greater, so equal items still keep their
+	// order.
+	#define item_less(a, b) (reverse ? sort_less(kind, (b).key, (a).key) : sort_less(kind, (a).key, (b).key))
+	if (size <= 12) {
+		for (size_t i = 1; i < size; ++i) {
+			SortItem item = items[i];
+			size_t j = i;
+			for (; j > 0 && item_less(item, items[j - 1]); --j)
+				items[j] = items[j - 1];
+			items[j] = item;
+			}
+		return;
+		}
+
+	size_t mid = size / 2;
+	merge_sort(items, scratch, mid, kind, reverse);
+	merge_sort(items + mid, scratch, size - mid, kind, reverse);
+	if (!item_less(items[mid], items[mid - 1])) {
+		// Already in order (which makes sorted input O(n)).
+		return;
+		}
+
+	memcpy(scratch, items, mid * sizeof(SortItem));
+	size_t left = 0, right = mid, out = 0;
+	while (left < mid && right < size) {
+		if (item_less(items[right], scratch[left]))
+			items[out++] = items[right++];
+		else
+			items[out++] = scratch[left++];
+		}
+	while (left < mid)
+		items[out++] = scratch[left++];
+	#undef item_less
+}
+
+void Array_sort(Array* self, Object* key, bool reverse)
+{
+	size_t size = self->size;
+	if (size < 2)
+		return;
+
+	// Get the keys, evaluating "key" just once per item.
+	Callback key_callback;
+	if (key)
+		Callback_init(&key_callback, key, "Array.sort");
+	SortItem* items = (SortItem*) alloc_mem(size * sizeof(SortItem));
+	for (size_t i = 0; i < size; ++i) {
+		items[i].item = self->items[i];
+		items[i].key = (key ? Callback_call(&key_callback, self->items[i], NULL, 0) : self->items[i]);
+		}
+
+	// Use a fast comparison if all the keys are Ints, numbers, or Strings.
+	bool all_ints = true, all_numbers = true, all_strings = true;
+	for (size_t i = 0; i < size; ++i) {
+		Class* key_class = (items[i].key ? items[i].key->class_ : NULL);
+		if (key_class != &Int_class)
+			all_ints = false;
+		if (key_class != &Int_class && key_class != &Float_class)
+			all_numbers = false;
+		if (key_class != &String_class)
+			all_strings = false;
+		}
+	SortKind kind =
+		all_ints ? SortInts :
+		all_numbers ? SortNumbers :
+		all_strings ? SortStrings :
+		SortGeneric;
+
+	SortItem* scratch = (SortItem*) alloc_mem((size / 2 + 1) * sizeof(SortItem));
+	merge_sort(items, scratch, size, kind, reverse);
+
+	// The key function or "<" could have changed the Array.
+	if (self->size != size)
+		Error("Array changed size while being sorted.");
+	for (size_t i = 0; i < size; ++i)
+		self->items[i] = items[i].item;
+}
+
+Object* Array_contains_builtin(Object* super, Object** args)
 {
 	Array* self = (Array*) super;
 	for (int i = 0; i < self->size; ++i) {
@@ -330,6 +562,114 @@ static Object* Array_contains_builtin(Object* super, Object** args)
 	return &false_obj;
 }
 
+declare_static_string(key_string, "key");
+declare_static_string(reverse_string, "reverse");
+
+static void Array_sort_with_options(Array* self, Object* options, const char* name)
+{
+	Object* key = NULL;
+	bool reverse = false;
+	if (options) {
+		if (options->class_ != &Dict_class)
+			Error("%s: options must be a Dict.", name);
+		key = Dict_at((Dict*) options, &key_string);
+		reverse = Dict_option_turned_on((Dict*) options, &reverse_string);
+		}
+	Array_sort(self, key, reverse);
+}
+
+Object* Array_sort_builtin(Object* super, Object** args)
+{
+	Array_sort_with_options((Array*) super, args[0], "Array.sort");
+	return super;
+}
+
+Object* Array_sorted_builtin(Object* super, Object** args)
+{
+	Array* copy = Array_copy((Array*) super);
+	Array_sort_with_options(copy, args[0], "Array.sorted");
+	return (Object*) copy;
+}
+
+Object* Array_each_builtin(Object* super, Object** args)
+{
+	Array* self = (Array*) super;
+	Callback callback;
+	Callback_init(&callback, args[0], "Array.each");
+	for (size_t i = 0; i < self->size; ++i)
+		Callback_call(&callback, self->items[i], NULL, 0);
+	return super;
+}
+
+Object* Array_map_builtin(Object* super, Object** args)
+{
+	Array* self = (Array*) super;
+	Callback callback;
+	Callback_init(&callback, args[0], "Array.map");
+	Array* result = new_Array();
+	for (size_t i = 0; i < self->size; ++i)
+		Array_append(result, Callback_call(&callback, self->items[i], NULL, 0));
+	return (Object*) result;
+}
+
+Object* Array_filter_builtin(Object* super, Object** args)
+{
+	// With no argument, keeps the truthy items.
+	Array* self = (Array*) super;
+	Callback callback;
+	if (args[0])
+		Callback_init(&callback, args[0], "Array.filter");
+	Array* result = new_Array();
+	for (size_t i = 0; i < self->size; ++i) {
+		Object* item = self->items[i];
+		if (IS_TRUTHY(args[0] ? Callback_call(&callback, item, NULL, 0) : item))
+			Array_append(result, item);
+		}
+	return (Object*) result;
+}
+
+Object* Array_reduce_builtin(Object* super, Object** args)
+{
+	// The method is called on the accumulated value, with the next item as its
+	// argument (eg. "numbers.reduce('+')").  With no initial value, the first
+	// item is the initial value.
+	Array* self = (Array*) super;
+	Callback callback;
+	Callback_init(&callback, args[0], "Array.reduce");
+	Object* result = args[1];
+	size_t i = 0;
+	if (result == NULL && self->size > 0)
+		result = self->items[i++];
+	for (; i < self->size; ++i)
+		result = Callback_call(&callback, result, &self->items[i], 1);
+	return result;
+}
+
+static Object* Array_any_all(Object* super, Object* spec, bool want, const char* name)
+{
+	// Returns "want" as soon as an item's result is "want".
+	Array* self = (Array*) super;
+	Callback callback;
+	if (spec)
+		Callback_init(&callback, spec, name);
+	for (size_t i = 0; i < self->size; ++i) {
+		Object* item = self->items[i];
+		if (IS_TRUTHY(spec ? Callback_call(&callback, item, NULL, 0) : item) == want)
+			return make_bool(want);
+		}
+	return make_bool(!want);
+}
+
+Object* Array_any_builtin(Object* super, Object** args)
+{
+	return Array_any_all(super, args[0], true, "Array.any");
+}
+
+Object* Array_all_builtin(Object* super, Object** args)
+{
+	return Array_any_all(super, args[0], false, "Array.all");
+}
+
 static void Array_remove_index(Array* array, int index)
 {
 	if (index < 0 || index >= array->size)
@@ -339,14 +679,14 @@ static void Array_remove_index(Array* array, int index)
 	array->size -= 1;
 }
 
-static Object* Array_remove_index_builtin(Object* super, Object** args)
+Object* Array_remove_index_builtin(Object* super, Object** args)
 {
 	Array* self = (Array*) super;
 	Array_remove_index(self, Int_enforce(args[0], "Array.remove-index"));
 	return super;
 }
 
-static Object* Array_remove_item_builtin(Object* super, Object** args)
+Object* Array_remove_item_builtin(Object* super, Object** args)
 {
 	Array* self = (Array*) super;
 	for (int i = 0; i < self->size; ++i) {
@@ -365,28 +705,7 @@ void Array_init_class()
 {
 	init_static_class(Array);
 
-	static BuiltinMethodSpec builtin_methods[] = {
-		{ "size", 0, Array_size_builtin },
-		{ "is-empty", 0, Array_is_empty_builtin },
-		{ "string", 0, Array_string_builtin },
-		{ "[]", 1, Array_at_builtin },
-		{ "[]=", 2, Array_at_set_builtin },
-		{ "+", 1, Array_plus_builtin },
-		{ "append", 1, Array_append_builtin },
-		{ "iterator", 0, Array_iterator_builtin },
-		{ "join", 1, Array_join_builtin },
-		{ "pop", 0, Array_pop_back_builtin },
-		{ "pop-back", 0, Array_pop_back_builtin },
-		{ "pop-front", 0, Array_pop_front_builtin },
-		{ "back", 0, Array_back_builtin },
-		{ "copy", 0, Array_copy_builtin },
-		{ "slice", 2, Array_slice_builtin },
-		{ "contains", 1, Array_contains_builtin },
-		{ "remove-index", 1, Array_remove_index_builtin },
-		{ "remove-item", 1, Array_remove_item_builtin },
-		{ NULL },
-		};
-	Class_add_builtin_methods(&Array_class, builtin_methods);
+	set_builtin_methods(Array);
 
 	ArrayIterator_init_class();
 }
@@ -423,11 +742,7 @@ void ArrayIterator_init_class()
 {
 	init_static_class(ArrayIterator);
 
-	static BuiltinMethodSpec builtin_methods[] = {
-		{ "next", 0, ArrayIterator_next },
-		{ NULL },
-		};
-	Class_add_builtin_methods(&ArrayIterator_class, builtin_methods);
+	set_builtin_methods(ArrayIterator);
 }
 
 
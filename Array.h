@@ -2,6 +2,7 @@
 
 #include <stddef.h>
 #include <stdlib.h>
+#include <stdbool.h>
 
 struct Object;
 struct Class;
@@ -12,6 +13,12 @@ typedef struct Array {
 	struct Class* class_;
 	size_t size, capacity;
 	struct Object** items;
+	size_t front;
+		// Free slots before "items", so pop_front() and push_front() don't need to
+		// move the other items.  "capacity" counts from "items".
+	bool is_slice;
+		// "items" points into another Array's block, so there's no room before it
+		// that this Array can use.
 	} Array;
 
 
@@ -20,9 +27,16 @@ extern struct Object* Array_at(Array* self, size_t index);
 extern struct Object* Array_set_at(Array* self, size_t index, struct Object* value);
 extern struct Object* Array_append(Array* self, struct Object* value);
 extern void Array_append_strings(Array* self, struct Object* value);
+extern void Array_reserve(Array* self, size_t capacity);
+extern void Array_extend(Array* self, Array* other);
 extern struct Object* Array_pop_back(Array* self);
+extern struct Object* Array_pop_front(Array* self);
+extern void Array_push_front(Array* self, struct Object* value);
 extern struct Object* Array_back(Array* self);
 extern Array* Array_copy(Array* self);
+extern void Array_sort(Array* self, struct Object* key, bool reverse);
+	// Stable.  "key" can be NULL, a method name, an index, or a Method; it's
+	// evaluated once per item.
 extern struct String* Array_join(Array* self, struct String* joiner);
 
 
@@ -16,17 +16,13 @@ Object* Boolean_string(Object* self, Object** args)
 
 void Boolean_init_class()
 {
-	Class_init_static(&Boolean_class, "Boolean", 0);
+	init_static_class_ivars(Boolean, 0);
 	true_obj.class_ = &Boolean_class;
 	false_obj.class_ = &Boolean_class;
 	String_init_static_c(&true_name, "true");
 	String_init_static_c(&false_name, "false");
 
-	static const BuiltinMethodSpec specs[] = {
-		{ "string", 0, Boolean_string },
-		{ NULL, 0, NULL },
-		};
-	Class_add_builtin_methods(&Boolean_class, specs);
+	set_builtin_methods(Boolean);
 }
 
 
@@ -84,7 +84,8 @@ void ByteArray_append_bytes(struct ByteArray* self, uint8_t* values, size_t size
 
 String* ByteArray_as_string(ByteArray* self)
 {
-	return new_static_String((char*) self->array, self->size);
+	// Copy the bytes; Strings are immutable, but the ByteArray isn't.
+	return new_String((char*) self->array, self->size);
 }
 
 
@@ -200,27 +201,10 @@ Object* ByteArray_iterator(Object* super, Object** args)
 void ByteArray_init_class()
 {
 	init_static_class(ByteArray);
-	static const BuiltinMethodSpec builtin_methods[] = {
-		{ "init", 1, ByteArray_init_builtin },
-		{ "size", 0, ByteArray_size_builtin },
-		{ "[]", 1, ByteArray_at_builtin },
-		{ "[]=", 1, ByteArray_set_at_builtin },
-		{ "append", 1, ByteArray_append_builtin },
-		{ "as-string", 0, ByteArray_as_string_builtin },
-		{ "slice", 2, ByteArray_slice },
-		{ "is-valid-utf8", 0, ByteArray_is_valid_utf8 },
-		{ "decode-8859-1", 0, ByteArray_decode_8859_1 },
-		{ "iterator", 0, ByteArray_iterator },
-		{ NULL },
-		};
-	Class_add_builtin_methods(&ByteArray_class, builtin_methods);
+	set_builtin_methods(ByteArray);
 
 	init_static_class(ByteArrayIterator);
-	static const BuiltinMethodSpec iterator_methods[] = {
-		{ "next", 0, ByteArrayIterator_next },
-		{ NULL },
-		};
-	Class_add_builtin_methods(&ByteArrayIterator_class, iterator_methods);
+	set_builtin_methods(ByteArrayIterator);
 }
 
 
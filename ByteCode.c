@@ -170,6 +170,12 @@ void interpret_bytecode(struct Method* method)
 
 				// Call the method.
 				if (value->class_ == &Method_class) {
+					if (Method_is_stub((Method*) value)) {
+						// First call; compile it.  Compiling can run code (imports), so
+						// protect our frame the same way as for a BuiltinMethod.
+						suspended_fp = frame + args_needed + 1;
+						Method_compile_stub((Method*) value);
+						}
 					if (frame + ((Method*) value)->stack_size >= stack_limit) {
 						fprintf(stderr, "Stack overflow!  Stack trace:\n");
 						dump_stack(frame, literals, 10);
@@ -332,38 +338,39 @@ void interpret_bytecode(struct Method* method)
 }
 
 
-Object* call_method_raw(Object* method, Object* receiver, Array* arguments)
+static Object* call_method_args(Object* method, Object* receiver, Object** args, int args_given)
 {
+	// "method" must already be compiled (not a stub).
 	static uint8_t terminator[] = { BC_TERMINATE };
 
-	if (stack == NULL)
-		init_bytecode_interpreter();
-
-	// If it's a BuiltinMethod, we can just call it.
-	if (method->class_ == &BuiltinMethod_class)
-		return ((BuiltinMethod*) method)->fn(receiver, (arguments ? arguments->items: NULL));
-	else if (method->class_ != &Method_class)
-		Error("Internal error: attempt to call a non-method.");
+	// If it's a BuiltinMethod, we can just call it.  Make sure it sees nil for
+	// any arguments that weren't given.
+	int args_needed = ((Method*) method)->num_args; 	// also works for BuiltinMethod
+	if (method->class_ == &BuiltinMethod_class) {
+		if (args_given < args_needed) {
+			Object* padded_args[args_needed];
+			for (int i = 0; i < args_needed; ++i)
+				padded_args[i] = (i < args_given ? args[i] : NULL);
+			return ((BuiltinMethod*) method)->fn(receiver, padded_args);
+			}
+		return ((BuiltinMethod*) method)->fn(receiver, args);
+		}
 
 	// Set up the stack frame for the call.
 	Object** orig_fp = suspended_fp;
-	suspended_fp += frame_saved_area_size;
-	Object** frame = suspended_fp;
+	Object** frame = suspended_fp + frame_saved_area_size;
+	if (frame + ((Method*) method)->stack_size >= stack_limit)
+		Error("Stack overflow!");
 	frame[-3] = (Object*) orig_fp;
 	frame[-2] = (Object*) terminator;
 	frame[-1] = NULL; 	// No literals in the terminator.
 	frame[0] = receiver;
 
 	// Copy the arguments to the frame.
-	int args_given = 0;
-	if (arguments) {
-		args_given = arguments->size;
-		for (int i = 0; i < args_given; ++i)
-			frame[i + 1] = arguments->items[i];
-		}
+	for (int i = 0; i < args_given; ++i)
+		frame[i + 1] = args[i];
 
 	// If there weren't enough arguments, fill the rest with nil.
-	int args_needed = ((Method*) method)->num_args; 	// also works for BuiltinMethod
 	while (args_given < args_needed) {
 		// These arg counts don't include "self".
 		frame[args_given + 1] = NULL;
@@ -371,6 +378,7 @@ Object* call_method_raw(Object* method, Object* receiver, Array* arguments)
 		}
 
 	// Call the method.
+	suspended_fp = frame;
 	interpret_bytecode((Method*) method);
 	Object* result = frame[-4];
 
@@ -380,6 +388,24 @@ Object* call_method_raw(Object* method, Object* receiver, Array* arguments)
 }
 
 
+Object* call_method_raw(Object* method, Object* receiver, Array* arguments)
+{
+	if (stack == NULL)
+		init_bytecode_interpreter();
+
+	if (method->class_ == &Method_class) {
+		if (Method_is_stub((Method*) method))
+			Method_compile_stub((Method*) method);
+		}
+	else if (method->class_ != &BuiltinMethod_class)
+		Error("Internal error: attempt to call a non-method.");
+
+	if (arguments == NULL)
+		return call_method_args(method, receiver, NULL, 0);
+	return call_method_args(method, receiver, arguments->items, arguments->size);
+}
+
+
 Object* call_object(Object* receiver, String* name, Array* arguments)
 {
 	// Find the method.
@@ -399,6 +425,66 @@ Object* call_method(struct Method* method, struct Array* arguments)
 }
 
 
+declare_static_string(at_string, "[]");
+
+void Callback_init(Callback* self, Object* spec, const char* name)
+{
+	if (stack == NULL)
+		init_bytecode_interpreter();
+
+	self->name = NULL;
+	self->index = NULL;
+	self->function = NULL;
+	self->cached_class = NULL;
+	self->cached_method = NULL;
+	if (spec == NULL)
+		Error("%s: missing method name.", name);
+	else if (spec->class_ == &String_class)
+		self->name = (String*) spec;
+	else if (spec->class_ == &Int_class) {
+		self->name = &at_string;
+		self->index = spec;
+		}
+	else if (spec->class_ == &Method_class || spec->class_ == &BuiltinMethod_class) {
+		self->function = spec;
+		if (spec->class_ == &Method_class && Method_is_stub((Method*) spec))
+			Method_compile_stub((Method*) spec);
+		}
+	else
+		Error("%s: expected a method name (a String) or an index (an Int), not a %s.", name, String_c_str(spec->class_->name));
+}
+
+
+Object* Callback_call(Callback* self, Object* item, Object** args, int num_args)
+{
+	if (self->function) {
+		Object* function_args[num_args + 1];
+		function_args[0] = item;
+		for (int i = 0; i < num_args; ++i)
+			function_args[i + 1] = args[i];
+		return call_method_args(self->function, NULL, function_args, num_args + 1);
+		}
+	if (self->index) {
+		args = &self->index;
+		num_args = 1;
+		}
+
+	// Items are usually all of one class, so only look up the method when the
+	// class changes.
+	Class* item_class = (item ? item->class_ : &Nil_class);
+	if (item_class != self->cached_class) {
+		Object* method = Object_find_method(item, self->name);
+		if (method == NULL)
+			Error("Unhandled method call: \"%s\" on %s.", String_c_str(self->name), String_c_str(item_class->name));
+		if (method->class_ == &Method_class && Method_is_stub((Method*) method))
+			Method_compile_stub((Method*) method);
+		self->cached_class = item_class;
+		self->cached_method = method;
+		}
+	return call_method_args(self->cached_method, item, args, num_args);
+}
+
+
 void print_object(Object* object)
 {
 	if (object == NULL) {
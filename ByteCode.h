@@ -77,9 +77,24 @@ enum {
 
 
 struct Method;
+struct Class;
 
 extern struct Object* call_object(struct Object* receiver, struct String* name, struct Array* arguments);
 extern struct Object* call_method(struct Method* method, struct Array* arguments);
+
+// For builtins that call back into scripts once per item, like Array.map().
+// The callback is given by "spec": a method name (a String) to call on each
+// item, an index (an Int) to index each item with, or a Method to call with the
+// item as its first argument.  Method lookups are cached.
+typedef struct Callback {
+	struct String* name;
+	struct Object* index;
+	struct Object* function;
+	struct Class* cached_class;
+	struct Object* cached_method;
+	} Callback;
+extern void Callback_init(Callback* self, struct Object* spec, const char* name);
+extern struct Object* Callback_call(Callback* self, struct Object* item, struct Object** args, int num_args);
 extern void dump_bytecode(struct Method* method, struct String* class_name, struct String* function_name);
 
 extern bool dump_requested;
@@ -0,0 +1,831 @@
+#include "ByteCodeCache.h"
+#include "Method.h"
+#include "Module.h"
+#include "Environment.h"
+#include "Class.h"
+#include "Object.h"
+#include "String.h"
+#include "Int.h"
+#include "Float.h"
+#include "Array.h"
+#include "ByteArray.h"
+#include "Dict.h"
+#include "File.h"
+#include "Search.h"
+#include "Memory.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+// The cache file is laid out as follows.  Numbers are in native byte order,
+// since the cache never leaves the machine.
+//
+//	magic, version
+//	checksum of the rest of the file
+//	interpreter info (to detect a rebuilt "sqs")
+//	number of sources, and for each: path, source info
+//		The first source is the script, the rest are its modules.
+//	number of missing paths, and each path
+//		Where modules were looked for but not found; if one of them appears, it
+//		would be used instead, so the cache is stale.
+//	number of modules, and for each: name, number of locals
+//	each module's Method, in the order the modules were run
+//	the script's Method
+//
+// Methods and Classes are written in full the first time they're seen, and
+// as a reference to the earlier one after that.  Objects from the global
+// environment are written by name, and a module's locals are written as the
+// module's index.
+
+static const char cache_magic[4] = { 's', 'q', 's', 'c' };
+#define cache_version 2
+#define no_count UINT32_MAX
+
+enum {
+	CO_NIL,
+	CO_REF, 	// u32 index
+	CO_STRING, 	// string
+	CO_INT, 	// i32
+	CO_FLOAT, 	// double
+	CO_METHOD, 	// num_args, stack_size, bytecode, literals
+	CO_CLASS, 	// name, superclass, num_ivars, slot names, methods
+	CO_OBJECT_CLASS,
+	CO_GLOBAL, 	// name
+	CO_MODULE_LOCALS, 	// u32 module index
+	};
+
+typedef struct SourceInfo {
+	uint64_t size;
+	int64_t mtime_sec, mtime_nsec;
+	uint64_t hash;
+	} SourceInfo;
+
+
+static uint64_t hash_bytes(const char* bytes, size_t size)
+{
+	// FNV-1a.
+	uint64_t hash = 14695981039346656037ULL;
+	for (; size > 0; --size, ++bytes) {
+		hash ^= (uint8_t) *bytes;
+		hash *= 1099511628211ULL;
+		}
+	return hash;
+}
+
+
+static bool get_source_info(const char* path, SourceInfo* info_out, bool with_hash)
+{
+	struct stat stat_buf;
+	if (stat(path, &stat_buf) < 0)
+		return false;
+	info_out->size = stat_buf.st_size;
+	info_out->mtime_sec = stat_buf.st_mtim.tv_sec;
+	info_out->mtime_nsec = stat_buf.st_mtim.tv_nsec;
+	info_out->hash = 0;
+	if (with_hash) {
+		String* contents = file_contents(path);
+		if (contents == NULL)
+			return false;
+		info_out->hash = hash_bytes(contents->str, contents->size);
+		}
+	return true;
+}
+
+
+static bool source_is_unchanged(const char* path, SourceInfo* cached_info)
+{
+	SourceInfo info;
+	if (!get_source_info(path, &info, false))
+		return false;
+	if (info.size != cached_info->size)
+		return false;
+	if (info.mtime_sec == cached_info->mtime_sec && info.mtime_nsec == cached_info->mtime_nsec)
+		return true;
+
+	// It's been touched, but it might not have changed.
+	if (!get_source_info(path, &info, true))
+		return false;
+	return info.hash == cached_info->hash;
+}
+
+
+static void make_dirs(char* path)
+{
+	for (char* p = path + 1; *p; ++p) {
+		if (*p == '/') {
+			*p = 0;
+			mkdir(path, 0700);
+			*p = '/';
+			}
+		}
+	mkdir(path, 0700);
+}
+
+
+static const char* cache_dir()
+{
+	const char* dir = getenv("SQS_CACHE_DIR");
+	if (dir && dir[0])
+		return dir;
+
+	char* path = alloc_mem_no_pointers(PATH_MAX);
+	const char* base = getenv("XDG_CACHE_HOME");
+	if (base && base[0])
+		snprintf(path, PATH_MAX, "%s/sqs", base);
+	else {
+		const char* home = getenv("HOME");
+		if (home == NULL || home[0] == 0)
+			return NULL;
+		snprintf(path, PATH_MAX, "%s/.cache/sqs", home);
+		}
+	return path;
+}
+
+
+static const char* cache_path_for(const char* script_path)
+{
+	if (getenv("SQS_NO_CACHE"))
+		return NULL;
+	const char* dir = cache_dir();
+	if (dir == NULL)
+		return NULL;
+
+	// The cache file is named for the script's real path.
+	char* real_path = realpath(script_path, NULL);
+	if (real_path == NULL)
+		return NULL;
+	uint64_t key = hash_bytes(real_path, strlen(real_path));
+	free(real_path);
+
+	char* path = alloc_mem_no_pointers(PATH_MAX);
+	snprintf(path, PATH_MAX, "%s/%016llx.sqsc", dir, (unsigned long long) key);
+	return path;
+}
+
+
+static bool get_interpreter_info(SourceInfo* info_out)
+{
+	if (!get_source_info("/proc/self/exe", info_out, false))
+		memset(info_out, 0, sizeof(SourceInfo));
+	return true;
+}
+
+
+
+typedef struct Writer {
+	ByteArray* bytes;
+	Dict* object_indices; 	// Identity: Method or Class -> index.
+	int num_objects;
+	Dict* global_names; 	// Identity: object -> name.
+	Array* modules;
+	bool ok;
+	} Writer;
+
+static void write_bytes(Writer* self, const void* bytes, size_t size)
+{
+	ByteArray_append_bytes(self->bytes, (uint8_t*) bytes, size);
+}
+
+static void write_u8(Writer* self, uint8_t value)
+{
+	ByteArray_append(self->bytes, value);
+}
+
+static void write_u32(Writer* self, uint32_t value)
+{
+	write_bytes(self, &value, sizeof(value));
+}
+
+static void write_string(Writer* self, String* string)
+{
+	write_u32(self, string->size);
+	write_bytes(self, string->str, string->size);
+}
+
+static void write_source_info(Writer* self, SourceInfo* info)
+{
+	write_bytes(self, info, sizeof(SourceInfo));
+}
+
+static size_t write_header(Writer* self)
+{
+	// Returns where the checksum goes; fill it in with write_checksum() once
+	// everything's been written.
+	write_bytes(self, cache_magic, sizeof(cache_magic));
+	write_u32(self, cache_version);
+	size_t checksum_offset = self->bytes->size;
+	uint64_t checksum = 0;
+	write_bytes(self, &checksum, sizeof(checksum));
+	return checksum_offset;
+}
+
+static void write_checksum(Writer* self, size_t checksum_offset)
+{
+	size_t start = checksum_offset + sizeof(uint64_t);
+	uint64_t checksum = hash_bytes((const char*) self->bytes->array + start, self->bytes->size - start);
+	memcpy(self->bytes->array + checksum_offset, &checksum, sizeof(checksum));
+}
+
+static void Writer_register(Writer* self, Object* object)
+{
+	IdentityDict_set_at(self->object_indices, object, (Object*) new_Int(self->num_objects));
+	self->num_objects += 1;
+}
+
+
+static void write_object(Writer* self, Object* object)
+{
+	if (!self->ok)
+		return;
+	if (object == NULL) {
+		write_u8(self, CO_NIL);
+		return;
+		}
+
+	// Module locals aren't objects, so look for them before looking at the
+	// class.
+	for (int i = 0; i < self->modules->size; ++i) {
+		Module* module = (Module*) self->modules->items[i];
+		if ((Object*) module->locals == object) {
+			write_u8(self, CO_MODULE_LOCALS);
+			write_u32(self, i);
+			return;
+			}
+		}
+
+	Object* index = IdentityDict_at(self->object_indices, object);
+	if (index) {
+		write_u8(self, CO_REF);
+		write_u32(self, Int_value(index));
+		return;
+		}
+	String* global_name = (String*) IdentityDict_at(self->global_names, object);
+	if (global_name) {
+		write_u8(self, CO_GLOBAL);
+		write_string(self, global_name);
+		return;
+		}
+
+	Class* class_ = object->class_;
+	if (class_ == &String_class) {
+		write_u8(self, CO_STRING);
+		write_string(self, (String*) object);
+		}
+	else if (class_ == &Int_class) {
+		write_u8(self, CO_INT);
+		int32_t value = Int_value(object);
+		write_bytes(self, &value, sizeof(value));
+		}
+	else if (class_ == &Float_class) {
+		write_u8(self, CO_FLOAT);
+		double value = Float_value(object);
+		write_bytes(self, &value, sizeof(value));
+		}
+	else if (class_ == &Method_class) {
+		Method* method = (Method*) object;
+		if (Method_is_stub(method))
+			Method_compile_stub(method);
+		Writer_register(self, object);
+		write_u8(self, CO_METHOD);
+		write_u32(self, method->num_args);
+		write_u32(self, method->stack_size);
+		write_u32(self, method->bytecode->size);
+		write_bytes(self, method->bytecode->array, method->bytecode->size);
+		write_u32(self, method->literals->size);
+		for (int i = 0; i < method->literals->size; ++i)
+			write_object(self, method->literals->items[i]);
+		}
+	else if (object == (Object*) &Object_class)
+		write_u8(self, CO_OBJECT_CLASS);
+	else if (class_ == &Class_class) {
+		// A class defined by the script.  (Builtin ones are all globals.)
+		Class* the_class = (Class*) object;
+		Writer_register(self, object);
+		write_u8(self, CO_CLASS);
+		write_string(self, the_class->name);
+		write_object(self, (Object*) the_class->superclass);
+		write_u32(self, the_class->num_ivars);
+		if (the_class->slot_names) {
+			write_u32(self, the_class->slot_names->size);
+			for (int i = 0; i < the_class->slot_names->size; ++i)
+				write_string(self, (String*) the_class->slot_names->items[i]);
+			}
+		else
+			write_u32(self, no_count);
+		if (the_class->methods) {
+			write_u32(self, the_class->methods->size);
+			DictIterator* it = new_DictIterator(the_class->methods);
+			while (true) {
+				DictIteratorResult kv = DictIterator_next(it);
+				if (kv.key == NULL)
+					break;
+				write_string(self, (String*) kv.key);
+				write_object(self, kv.value);
+				}
+			}
+		else
+			write_u32(self, no_count);
+		}
+	else {
+		// Something we don't know how to cache.
+		self->ok = false;
+		}
+}
+
+
+static void Writer_init(Writer* self)
+{
+	// Compile everything.  This has to happen before writing starts, because
+	// compiling can build more modules.
+	Method_compile_all_stubs();
+
+	self->bytes = new_ByteArray();
+	self->object_indices = new_Dict();
+	self->num_objects = 0;
+	self->global_names = new_Dict();
+	self->modules = Module_get_built_modules();
+	self->ok = true;
+	DictIterator* it = new_DictIterator(global_environment.dict);
+	while (true) {
+		DictIteratorResult kv = DictIterator_next(it);
+		if (kv.key == NULL)
+			break;
+		if (kv.value)
+			IdentityDict_set_at(self->global_names, kv.value, (Object*) kv.key);
+		}
+}
+
+
+static void write_program(Writer* self, Method* method)
+{
+	Array* modules = self->modules;
+
+	// Modules.
+	write_u32(self, modules->size);
+	for (int i = 0; i < modules->size; ++i) {
+		Module* module = (Module*) modules->items[i];
+		write_string(self, module->name);
+		write_u32(self, module->num_locals);
+		}
+	for (int i = 0; i < modules->size; ++i)
+		write_object(self, (Object*) ((Module*) modules->items[i])->method);
+
+	// The script.
+	write_object(self, (Object*) method);
+}
+
+
+uint64_t ByteCodeCache_source_hash(String* contents)
+{
+	return hash_bytes(contents->str, contents->size);
+}
+
+
+bool ByteCodeCache_save(const char* script_path, uint64_t script_hash, Method* method)
+{
+	const char* cache_path = cache_path_for(script_path);
+	if (cache_path == NULL)
+		return false;
+
+	Writer writer;
+	Writer_init(&writer);
+	Array* modules = writer.modules;
+
+	// Header.
+	size_t checksum_offset = write_header(&writer);
+	SourceInfo info;
+	get_interpreter_info(&info);
+	write_source_info(&writer, &info);
+
+	// Sources.
+	write_u32(&writer, modules->size + 1);
+	if (!get_source_info(script_path, &info, true) || info.hash != script_hash)
+		return false;
+	write_string(&writer, new_c_static_String(script_path));
+	write_source_info(&writer, &info);
+	for (int i = 0; i < modules->size; ++i) {
+		Module* module = (Module*) modules->items[i];
+		if (module->path == NULL || !get_source_info(String_c_str(module->path), &info, true))
+			return false;
+		if (info.hash != module->source_hash)
+			return false;
+		write_string(&writer, module->path);
+		write_source_info(&writer, &info);
+		}
+	int num_missing_paths = 0;
+	for (int i = 0; i < modules->size; ++i) {
+		if (((Module*) modules->items[i])->missing_path)
+			num_missing_paths += 1;
+		}
+	write_u32(&writer, num_missing_paths);
+	for (int i = 0; i < modules->size; ++i) {
+		Module* module = (Module*) modules->items[i];
+		if (module->missing_path)
+			write_string(&writer, module->missing_path);
+		}
+
+	write_program(&writer, method);
+	if (!writer.ok)
+		return false;
+	write_checksum(&writer, checksum_offset);
+
+	// Write it to a temporary file, then move it into place, so another sqs
+	// never sees a partial cache file.
+	const char* dir = cache_dir();
+	char* dir_copy = alloc_mem_no_pointers(strlen(dir) + 1);
+	strcpy(dir_copy, dir);
+	make_dirs(dir_copy);
+	char* temp_path = alloc_mem_no_pointers(PATH_MAX);
+	snprintf(temp_path, PATH_MAX, "%s.XXXXXX", cache_path);
+	int fd = mkstemp(temp_path);
+	if (fd < 0)
+		return false;
+	FILE* file = fdopen(fd, "w");
+	if (file == NULL) {
+		close(fd);
+		unlink(temp_path);
+		return false;
+		}
+	bool ok = fwrite(writer.bytes->array, 1, writer.bytes->size, file) == writer.bytes->size;
+	if (fclose(file) != 0)
+		ok = false;
+	if (ok)
+		ok = rename(temp_path, cache_path) == 0;
+	if (!ok)
+		unlink(temp_path);
+	return ok;
+}
+
+
+
+typedef struct Reader {
+	const char* p;
+	const char* end;
+	Array* objects;
+	Array* modules;
+	Array* source_paths; 	// NULL if there are no sources.
+	bool ok;
+	} Reader;
+
+static void Reader_init(Reader* self, const char* bytes, size_t size)
+{
+	self->p = bytes;
+	self->end = bytes + size;
+	self->objects = new_Array();
+	self->modules = new_Array();
+	self->source_paths = NULL;
+	self->ok = true;
+}
+
+static bool read_bytes(Reader* self, void* bytes_out, size_t size)
+{
+	if (!self->ok || self->end - self->p < size) {
+		self->ok = false;
+		memset(bytes_out, 0, size);
+		return false;
+		}
+	memcpy(bytes_out, self->p, size);
+	self->p += size;
+	return true;
+}
+
+static uint8_t read_u8(Reader* self)
+{
+	uint8_t value;
+	read_bytes(self, &value, sizeof(value));
+	return value;
+}
+
+static uint32_t read_u32(Reader* self)
+{
+	uint32_t value;
+	read_bytes(self, &value, sizeof(value));
+	return value;
+}
+
+static bool read_header(Reader* self)
+{
+	// Checks the magic number and version, and that the rest of the file matches
+	// its checksum, so a truncated or corrupted file is never decoded.
+	char magic[sizeof(cache_magic)];
+	read_bytes(self, magic, sizeof(magic));
+	if (!self->ok || memcmp(magic, cache_magic, sizeof(magic)) != 0)
+		return false;
+	if (read_u32(self) != cache_version)
+		return false;
+	uint64_t checksum;
+	read_bytes(self, &checksum, sizeof(checksum));
+	return self->ok && checksum == hash_bytes(self->p, self->end - self->p);
+}
+
+static String* read_string(Reader* self)
+{
+	uint32_t size = read_u32(self);
+	if (!self->ok || self->end - self->p < size) {
+		self->ok = false;
+		return &empty_string;
+		}
+	String* string = new_String(self->p, size);
+	self->p += size;
+	return string;
+}
+
+
+static Object* read_object(Reader* self)
+{
+	uint8_t tag = read_u8(self);
+	if (!self->ok)
+		return NULL;
+	switch (tag) {
+		case CO_NIL:
+			return NULL;
+
+		case CO_REF:
+			{
+			uint32_t index = read_u32(self);
+			if (index >= self->objects->size) {
+				self->ok = false;
+				return NULL;
+				}
+			return self->objects->items[index];
+			}
+
+		case CO_STRING:
+			return (Object*) read_string(self);
+
+		case CO_INT:
+			{
+			int32_t value;
+			read_bytes(self, &value, sizeof(value));
+			return (Object*) new_Int(value);
+			}
+
+		case CO_FLOAT:
+			{
+			double value;
+			read_bytes(self, &value, sizeof(value));
+			return (Object*) new_Float(value);
+			}
+
+		case CO_METHOD:
+			{
+			Method* method = alloc_obj(Method);
+			method->class_ = &Method_class;
+			Array_append(self->objects, (Object*) method);
+			method->num_args = read_u32(self);
+			method->stack_size = read_u32(self);
+			uint32_t size = read_u32(self);
+			if (!self->ok || self->end - self->p < size) {
+				self->ok = false;
+				return NULL;
+				}
+			method->bytecode = new_ByteArray();
+			ByteArray_append_bytes(method->bytecode, (uint8_t*) self->p, size);
+			self->p += size;
+			method->literals = new_Array();
+			uint32_t num_literals = read_u32(self);
+			for (uint32_t i = 0; i < num_literals && self->ok; ++i)
+				Array_append(method->literals, read_object(self));
+			return (Object*) method;
+			}
+
+		case CO_CLASS:
+			{
+			Class* the_class = new_Class(read_string(self));
+			Array_append(self->objects, (Object*) the_class);
+			Object* superclass = read_object(self);
+			if (superclass && superclass->class_ != &Class_class)
+				self->ok = false;
+			the_class->superclass = (Class*) superclass;
+			the_class->num_ivars = read_u32(self);
+			uint32_t num_slot_names = read_u32(self);
+			if (num_slot_names != no_count) {
+				the_class->slot_names = new_Array();
+				for (uint32_t i = 0; i < num_slot_names && self->ok; ++i)
+					Array_append(the_class->slot_names, (Object*) read_string(self));
+				}
+			uint32_t num_methods = read_u32(self);
+			if (num_methods != no_count) {
+				the_class->methods = new_Dict();
+				for (uint32_t i = 0; i < num_methods && self->ok; ++i) {
+					String* name = read_string(self);
+					Dict_set_at(the_class->methods, name, read_object(self));
+					}
+				}
+			return (Object*) the_class;
+			}
+
+		case CO_OBJECT_CLASS:
+			return (Object*) &Object_class;
+
+		case CO_GLOBAL:
+			{
+			Object* value = Dict_at(global_environment.dict, read_string(self));
+			if (value == NULL)
+				self->ok = false;
+			return value;
+			}
+
+		case CO_MODULE_LOCALS:
+			{
+			uint32_t index = read_u32(self);
+			if (index >= self->modules->size) {
+				self->ok = false;
+				return NULL;
+				}
+			return (Object*) ((Module*) self->modules->items[index])->locals;
+			}
+		}
+
+	self->ok = false;
+	return NULL;
+}
+
+
+static Method* read_method(Reader* self)
+{
+	Object* object = read_object(self);
+	if (object == NULL || object->class_ != &Method_class) {
+		self->ok = false;
+		return NULL;
+		}
+	return (Method*) object;
+}
+
+
+static Method* read_program(Reader* self)
+{
+	// Modules.
+	uint32_t num_modules = read_u32(self);
+	if (!self->ok || (self->source_paths && num_modules + 1 != self->source_paths->size))
+		return NULL;
+	for (uint32_t i = 0; i < num_modules && self->ok; ++i) {
+		String* name = read_string(self);
+		uint32_t num_locals = read_u32(self);
+		String* path = (self->source_paths ? (String*) self->source_paths->items[i + 1] : NULL);
+		Module* module = new_prebuilt_Module(name, path, num_locals);
+		Array_append(self->modules, (Object*) module);
+		}
+	for (uint32_t i = 0; i < num_modules && self->ok; ++i)
+		((Module*) self->modules->items[i])->method = read_method(self);
+
+	// The script.
+	Method* method = read_method(self);
+	if (!self->ok || self->p != self->end)
+		return NULL;
+
+	// Run the modules, as compiling would have.
+	for (uint32_t i = 0; i < num_modules; ++i)
+		Module_run_prebuilt((Module*) self->modules->items[i]);
+
+	return method;
+}
+
+
+Method* ByteCodeCache_load(const char* script_path)
+{
+	const char* cache_path = cache_path_for(script_path);
+	if (cache_path == NULL)
+		return NULL;
+	String* contents = file_contents(cache_path);
+	if (contents == NULL)
+		return NULL;
+
+	Reader reader;
+	Reader_init(&reader, contents->str, contents->size);
+	reader.source_paths = new_Array();
+
+	// Header.
+	if (!read_header(&reader))
+		return NULL;
+	SourceInfo info, cached_info;
+	get_interpreter_info(&info);
+	read_bytes(&reader, &cached_info, sizeof(cached_info));
+	if (!reader.ok || info.size != cached_info.size || info.mtime_sec != cached_info.mtime_sec || info.mtime_nsec != cached_info.mtime_nsec)
+		return NULL;
+
+	// Sources.  The script is checked by the path it's being run with now.
+	uint32_t num_sources = read_u32(&reader);
+	for (uint32_t i = 0; i < num_sources && reader.ok; ++i) {
+		String* path = read_string(&reader);
+		read_bytes(&reader, &cached_info, sizeof(cached_info));
+		if (!reader.ok)
+			return NULL;
+		const char* check_path = (i == 0 ? script_path : String_c_str(path));
+		if (!source_is_unchanged(check_path, &cached_info))
+			return NULL;
+		Array_append(reader.source_paths, (Object*) path);
+		}
+	if (!reader.ok || num_sources == 0)
+		return NULL;
+	uint32_t num_missing_paths = read_u32(&reader);
+	for (uint32_t i = 0; i < num_missing_paths && reader.ok; ++i) {
+		String* path = read_string(&reader);
+		struct stat stat_buf;
+		if (reader.ok && stat(String_c_str(path), &stat_buf) == 0 && S_ISREG(stat_buf.st_mode))
+			return NULL;
+		}
+	if (!reader.ok)
+		return NULL;
+
+	return read_program(&reader);
+}
+
+
+
+
+// A bundle is a copy of the sqs executable with a compiled program appended to
+// it.  The program is the same as in a cache file, minus the interpreter and
+// source info; the bundle can't get out of sync with either.
+// The bundle's copy of "bundle_marker" is patched with the program's size, so
+// a plain sqs can tell it isn't a bundle without reading its own executable.
+
+typedef struct BundleMarker {
+	char magic[16];
+	uint64_t program_size;
+	} BundleMarker;
+
+static volatile BundleMarker bundle_marker = { "sqs bundle mark", 0 };
+
+
+bool ByteCodeCache_save_bundle(const char* output_path, Method* method)
+{
+	Writer writer;
+	Writer_init(&writer);
+	size_t checksum_offset = write_header(&writer);
+	write_program(&writer, method);
+	if (!writer.ok)
+		return false;
+	write_checksum(&writer, checksum_offset);
+
+	// Read the interpreter, and find its marker.  It has to be there exactly
+	// once, or we could patch the wrong bytes.
+	String* interpreter = file_contents("/proc/self/exe");
+	if (interpreter == NULL)
+		return false;
+	char magic[sizeof(bundle_marker.magic)];
+	for (size_t i = 0; i < sizeof(magic); ++i)
+		magic[i] = bundle_marker.magic[i];
+	const char* marker = find_bytes(interpreter->str, interpreter->size, magic, sizeof(magic));
+	if (marker == NULL || (size_t) (marker - interpreter->str) + sizeof(BundleMarker) > interpreter->size)
+		return false;
+	const char* after_marker = marker + sizeof(magic);
+	if (find_bytes(after_marker, interpreter->str + interpreter->size - after_marker, magic, sizeof(magic)))
+		return false;
+	BundleMarker new_marker;
+	memcpy(new_marker.magic, magic, sizeof(magic));
+	new_marker.program_size = writer.bytes->size;
+
+	// Write the interpreter (but not any program that's already bundled with
+	// it), with the patched marker, and then the program.
+	FILE* file = fopen(output_path, "wb");
+	if (file == NULL)
+		return false;
+	size_t marker_offset = marker - interpreter->str;
+	size_t interpreter_size = interpreter->size - bundle_marker.program_size;
+	size_t rest_offset = marker_offset + sizeof(BundleMarker);
+	bool ok =
+		fwrite(interpreter->str, 1, marker_offset, file) == marker_offset &&
+		fwrite(&new_marker, sizeof(new_marker), 1, file) == 1 &&
+		fwrite(interpreter->str + rest_offset, 1, interpreter_size - rest_offset, file) == interpreter_size - rest_offset &&
+		fwrite(writer.bytes->array, 1, writer.bytes->size, file) == writer.bytes->size;
+	if (fclose(file) != 0)
+		ok = false;
+	if (ok)
+		ok = chmod(output_path, 0755) == 0;
+	if (!ok)
+		unlink(output_path);
+	return ok;
+}
+
+
+Method* ByteCodeCache_load_bundle()
+{
+	uint64_t program_size = bundle_marker.program_size;
+	if (program_size == 0)
+		return NULL;
+
+	FILE* file = fopen("/proc/self/exe", "rb");
+	if (file == NULL)
+		return NULL;
+	char* program = alloc_mem_no_pointers(program_size);
+	bool ok =
+		fseek(file, -(long) program_size, SEEK_END) == 0 &&
+		fread(program, 1, program_size, file) == program_size;
+	fclose(file);
+	if (!ok)
+		return NULL;
+
+	Reader reader;
+	Reader_init(&reader, program, program_size);
+	if (!read_header(&reader))
+		return NULL;
+	return read_program(&reader);
+}
+
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Compiled scripts are cached on disk, so later runs can skip lexing, parsing,
+// and compiling.  The cache for a script covers it and all the modules it
+// imports, and is only used if none of their source files have changed.
+//
+// The cache directory is $SQS_CACHE_DIR, or else "$XDG_CACHE_HOME/sqs" or
+// "~/.cache/sqs".  Setting $SQS_NO_CACHE turns caching off.
+
+struct Method;
+struct String;
+
+extern struct Method* ByteCodeCache_load(const char* script_path);
+	// Returns NULL if there's no valid cache for the script.  Otherwise, runs any
+	// modules the script imported, and returns the script's Method.
+extern bool ByteCodeCache_save(const char* script_path, uint64_t script_hash, struct Method* method);
+	// Compiles anything that hasn't been compiled yet, so this is best done
+	// after the script has run.  Nothing is saved if the script or a module has
+	// changed since it was parsed; "script_hash" is the script's
+	// ByteCodeCache_source_hash().
+extern uint64_t ByteCodeCache_source_hash(struct String* contents);
+
+// A script can also be bundled into a standalone executable: a copy of sqs
+// with the compiled script and its modules appended.
+extern bool ByteCodeCache_save_bundle(const char* output_path, struct Method* method);
+extern struct Method* ByteCodeCache_load_bundle();
+	// Returns NULL if this sqs isn't a bundle.  Otherwise, runs the bundled
+	// modules, and returns the script's Method.
+
@@ -9,11 +9,11 @@
 Class Class_class;
 
 
-void Class_init_static(Class* self, const char* name, int num_ivars)
+void Class_init_static(Class* self, struct String* name, int num_ivars)
 {
 	self->class_ = &Class_class;
 	self->superclass = &Object_class;
-	self->name = new_c_static_String(name);
+	self->name = name;
 	self->num_ivars = num_ivars;
 }
 
@@ -36,28 +36,6 @@ Object* Class_instantiate(Class* self)
 }
 
 
-void Class_add_builtin_methods(Class* self, const BuiltinMethodSpec* specs)
-{
-	if (self->methods == NULL)
-		self->methods = new_Dict();
-
-	// Count the specs.
-	int num_specs = 0;
-	for (const BuiltinMethodSpec* spec = specs; spec->name; ++spec)
-		num_specs += 1;
-
-	// We'll make them as one big chunk with all the objects in it.
-	BuiltinMethod* methods = (BuiltinMethod*) alloc_mem(num_specs * sizeof(BuiltinMethod));
-	BuiltinMethod* method = methods;
-	for (const BuiltinMethodSpec* spec = specs; spec->name; ++spec, ++method) {
-		method->class_ = &BuiltinMethod_class;
-		method->num_args = spec->num_args;
-		method->fn = spec->fn;
-		Dict_set_at(self->methods, new_c_static_String(spec->name), (Object*) method);
-		}
-}
-
-
 Object* Class_find_super_method(Class* self, struct String* name)
 {
 	Class* class_ = (self->superclass ? self->superclass : NULL);
@@ -100,14 +78,7 @@ void Class_init_class()
 {
 	init_static_class(Class);
 
-	static BuiltinMethodSpec builtin_methods[] = {
-		{ "string", 0, Class_string },
-		{ "name", 0, Class_name },
-		{ "superclass", 0, Class_superclass },
-		{ "num-ivars", 0, Class_num_ivars },
-		{ NULL, 0, NULL },
-		};
-	Class_add_builtin_methods(&Class_class, builtin_methods);
+	set_builtin_methods(Class);
 }
 
 
@@ -1,6 +1,7 @@
 #pragma once
 
-struct String;
+#include "String.h"
+
 struct Dict;
 struct Object;
 struct Array;
@@ -14,16 +15,7 @@ typedef struct Class {
 	struct Array* slot_names;
 	} Class;
 
-
-typedef struct BuiltinMethodSpec {
-	const char* name;
-	int num_args;
-	struct Object* (*fn)(struct Object* self, struct Object** args);
-	} BuiltinMethodSpec;
-
-extern void Class_init_static(Class* self, const char* name, int num_ivars);
-extern void Class_add_builtin_methods(Class* self, const BuiltinMethodSpec* specs);
-	// "specs" is a list, terminated by a NULL entry.
+extern void Class_init_static(Class* self, struct String* name, int num_ivars);
 extern Class* new_Class(struct String* name);
 extern struct Object* Class_instantiate(Class* self);
 extern struct Object* Class_find_super_method(Class* self, struct String* name);
@@ -32,6 +24,20 @@ extern Class Class_class;
 extern void Class_init_class();
 
 #define NumIvarsFor(type) ((sizeof(type) + sizeof(struct Object*) - 1) / sizeof(struct Object*) - 1)
-#define init_static_class(type) (Class_init_static(&type##_class, #type, NumIvarsFor(type)))
+#define init_static_class(type) init_static_class_ivars(type, NumIvarsFor(type))
+#define init_static_class_ivars(type, num_ivars) \
+	do { \
+		static struct String type##_name; \
+		String_init_static_c(&type##_name, #type); \
+		Class_init_static(&type##_class, &type##_name, num_ivars); \
+		} while (0)
+
+// Builtin classes' methods are listed in BuiltinTables.def, and made into
+// "<type>_builtin_methods" at build time.
+#define set_builtin_methods(type) \
+	do { \
+		extern struct Dict type##_builtin_methods; \
+		type##_class.methods = &type##_builtin_methods; \
+		} while (0)
 
 
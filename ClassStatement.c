@@ -9,6 +9,7 @@
 #include "Dict.h"
 #include "Class.h"
 #include "Object.h"
+#include "Region.h"
 #include "Memory.h"
 #include "Error.h"
 #include <stdio.h>
@@ -51,7 +52,7 @@ ParseNode* Parser_parse_class_statement(Parser* self)
 
 	// Superclass.
 	token = Lexer_peek(self->lexer);
-	if (token.type == Operator && String_equals_c(token.token, ":")) {
+	if (token.type == Operator && token.kind == K_COLON) {
 		Lexer_next(self->lexer);
 		token = Lexer_next(self->lexer);
 		if (token.type != Identifier)
@@ -82,7 +83,7 @@ ParseNode* Parser_parse_class_statement(Parser* self)
 				}
 
 			// Ivars.
-			else if (token.type == Operator && String_equals_c(token.token, "(")) {
+			else if (token.type == Operator && token.kind == K_LPAREN) {
 				Array* arg_names = Parser_parse_names_list(self, "argument");
 				token = Lexer_next(self->lexer);
 				if (token.type != EOL)
@@ -97,7 +98,7 @@ ParseNode* Parser_parse_class_statement(Parser* self)
 				}
 
 			// "class"
-			else if (token.type == Identifier && String_equals_c(token.token, "class")) {
+			else if (token.type == Identifier && token.kind == K_CLASS) {
 				ClassStatement* enclosed_class = (ClassStatement*) Parser_parse_class_statement(self);
 				if (class_statement->enclosed_classes == NULL)
 					class_statement->enclosed_classes = new_Dict();
@@ -111,7 +112,7 @@ ParseNode* Parser_parse_class_statement(Parser* self)
 			// Anything else is a function.
 
 			// It might be preceded by "fn", or not.
-			if (token.type == Identifier && String_equals_c(token.token, "fn")) {
+			if (token.type == Identifier && token.kind == K_FN) {
 				Lexer_next(self->lexer);
 				token = Lexer_next(self->lexer);
 				if (token.type != Identifier && token.type != Operator)
@@ -163,33 +164,37 @@ int ClassStatement_emit(ParseNode* super, MethodBuilder* method)
 
 	// Compile functions.
 	// Set up environment.
-	ClassFunctionContext context;
-	ClassFunctionContext_init(&context, self, method->environment);
-	method->environment = (Environment*) &context;
-	// Compile all functions.
+	// (It's allocated because lazily-compiled functions hold on to it.)
+	ClassFunctionContext* context = alloc_compiler_obj(ClassFunctionContext);
+	ClassFunctionContext_init(context, self, method->environment);
+	method->environment = (Environment*) context;
+	// Compile all functions (lazily, unless we need to dump them now).
 	DictIterator* it = new_DictIterator(self->functions);
 	while (true) {
 		DictIteratorResult kv = DictIterator_next(it);
 		if (kv.key == NULL)
 			break;
 		FunctionStatement* function = (FunctionStatement*) kv.value;
-		Object* compiled_method = FunctionStatement_compile(function, method->environment);
+		Object* compiled_method = NULL;
 		if (dump_requested) {
-			dump_bytecode((struct Method*) compiled_method, self->built_class->name, kv.key);
+			compiled_method = FunctionStatement_compile(function, method->environment);
+			dump_bytecode((struct Method*) compiled_method, self->built_class->name, (String*) kv.key);
 			printf("\n");
 			}
+		else
+			compiled_method = FunctionStatement_compile_lazily(function, method->environment);
 		if (self->built_class->methods == NULL)
 			self->built_class->methods = new_Dict();
 		Dict_set_at(self->built_class->methods, function->name, compiled_method);
 		}
 	// Clean up environment.
-	method->environment = context.environment.parent;
+	method->environment = context->environment.parent;
 
 	// Compile enclosed classes.
 	if (self->enclosed_classes) {
-		EnclosedClassContext enclosed_class_context;
-		EnclosedClassContext_init(&enclosed_class_context, self, method->environment);
-		method->environment = &enclosed_class_context.environment;
+		EnclosedClassContext* enclosed_class_context = alloc_compiler_obj(EnclosedClassContext);
+		EnclosedClassContext_init(enclosed_class_context, self, method->environment);
+		method->environment = &enclosed_class_context->environment;
 
 		DictIterator* it = new_DictIterator(self->enclosed_classes);
 		while (true) {
@@ -200,7 +205,7 @@ int ClassStatement_emit(ParseNode* super, MethodBuilder* method)
 			ClassStatement_emit((ParseNode*) enclosed_class, method);
 			}
 
-		method->environment = enclosed_class_context.environment.parent;
+		method->environment = enclosed_class_context->environment.parent;
 		}
 
 	self->is_building = false;
@@ -210,7 +215,7 @@ int ClassStatement_emit(ParseNode* super, MethodBuilder* method)
 
 ClassStatement* new_ClassStatement(String* name)
 {
-	ClassStatement* self = alloc_obj(ClassStatement);
+	ClassStatement* self = alloc_compiler_obj(ClassStatement);
 	self->parse_node.type = PN_ClassStatement;
 	self->parse_node.emit = ClassStatement_emit;
 	self->built_class = new_Class(name);
@@ -271,7 +276,7 @@ int IvarExpr_emit_set(ParseNode* super, ParseNode* value, MethodBuilder* method)
 
 IvarExpr* new_IvarExpr(int ivar_index)
 {
-	IvarExpr* self = alloc_obj(IvarExpr);
+	IvarExpr* self = alloc_compiler_obj(IvarExpr);
 	self->parse_node.emit = IvarExpr_emit;
 	self->parse_node.emit_set = IvarExpr_emit_set;
 	self->ivar_index = ivar_index;
@@ -1,31 +1,25 @@
 #include "Dict.h"
 #include "String.h"
 #include "Class.h"
-#include "Array.h"
 #include "Object.h"
+#include "Array.h"
 #include "Boolean.h"
 #include "Int.h"
+#include "Float.h"
+#include "Path.h"
+#include "ByteCode.h"
+#include "BuiltinMethod.h"
 #include "Memory.h"
 #include "Error.h"
 #include <string.h>
+#include <limits.h>
 #include <stdio.h>
 
-typedef uint16_t Dict_index_t;
-#define MAX_NODES UINT16_MAX
-
-typedef struct DictNode {
-	Dict_index_t left, right;
-	Dict_index_t level;
-	String* key;
-	struct Object* value;
-	} DictNode;
-
-#define capacity_increment 32
+#define min_slots 8
+#define no_slot UINT32_MAX
 
-// Index zero represents a null "pointer".  The node at index zero has the tree
-// root as its "left".
-
-#define Node(index) (self->tree[index])
+// The slots are a power-of-two-sized, linearly-probed table of indices into
+// "entries".  It's kept at most 2/3 full, and doubles when it would get fuller.
 
 
 Class Dict_class;
@@ -33,115 +27,213 @@ static Class DictIterator_class;
 static Class DictIteratorKeyValue_class;
 
 
+static uint32_t mix_hash(uint32_t hash)
+{
+	// Spread the bits out, so keys like multiples of 1024 don't all land in the
+	// same slot.  (This is MurmurHash3's finalizer.)
+	hash ^= hash >> 16;
+	hash *= 0x85EBCA6BU;
+	hash ^= hash >> 13;
+	hash *= 0xC2B2AE35U;
+	hash ^= hash >> 16;
+	return hash;
+}
 
-static Dict_index_t Dict_skew(Dict* self, Dict_index_t node)
+static uint32_t identity_hash(Object* key)
 {
-	if (node == 0)
-		return 0;
-	DictNode* t = &Node(node);
-	if (t->left == 0)
-		return node;
-	Dict_index_t left = t->left;
-	DictNode* l = &Node(left);
-	if (l->level == t->level) {
-		// Swap the pointers of the horizontal left links.
-		t->left = l->right;
-		l->right = node;
-		return left;
+	uintptr_t bits = (uintptr_t) key;
+	return mix_hash((uint32_t) bits ^ (uint32_t) ((uint64_t) bits >> 32));
+}
+
+declare_static_string(hash_string, "hash");
+declare_static_string(equals_string, "==");
+
+static uint32_t Dict_hash_key(Object* key)
+{
+	// Builtin types are hashed directly, without calling their "hash" methods.
+	// Objects without a "hash" method are hashed (and compared) by identity.
+	if (key == NULL)
+		Error("Dict keys can't be nil.");
+	Class* key_class = key->class_;
+	if (key_class == &String_class)
+		return String_hash((String*) key);
+	else if (key_class == &Int_class)
+		return mix_hash(Int_value(key));
+	else if (key_class == &Float_class) {
+		// Floats that equal an Int must hash the same as it.
+		double value = Float_value(key);
+		if (value >= INT_MIN && value <= INT_MAX && value == (int) value)
+			return mix_hash((int) value);
+		uint64_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		return mix_hash((uint32_t) bits ^ (uint32_t) (bits >> 32));
 		}
-	return node;
-}
-
-
-static Dict_index_t Dict_split(Dict* self, Dict_index_t node)
-{
-	if (node == 0)
-		return 0;
-	DictNode* t = &Node(node);
-	Dict_index_t right = t->right;
-	if (right == 0)
-		return node;
-	DictNode* r = &Node(right);
-	Dict_index_t right_right = r->right;
-	if (right_right == 0)
-		return node;
-	if (Node(node).level == Node(right_right).level) {
-		// We have two horizontal right links.  Elevate the middle node as the root
-		// of this subtree.
-		t->right = r->left;
-		r->left = node;
-		r->level += 1;
-		return right;
+	else if (key_class == &Path_class) {
+		const char* path = ((Path*) key)->path;
+		return String_hash_c(path, strlen(path));
 		}
-	return node;
+	if (Object_find_method(key, &hash_string) == NULL)
+		return identity_hash(key);
+	Object* hash = call_object(key, &hash_string, NULL);
+	return mix_hash(Int_enforce(hash, "Dict key \"hash\" method"));
 }
 
-static Dict_index_t Dict_create_node(Dict* self, struct String* key, struct Object* value)
+static bool Dict_keys_equal(Object* entry_key, Object* key)
 {
-	if (self->size + 1 >= self->capacity) {
-		int old_capacity = self->capacity;
-		self->capacity += capacity_increment;
-		if (self->capacity > MAX_NODES)
-			Error("Dictionary overflow!  Dicts only support up to %d entries.", MAX_NODES);
-		self->tree = realloc_mem(self->tree, self->capacity * sizeof(DictNode));
-		memset(self->tree + old_capacity, 0, capacity_increment * sizeof(DictNode));
+	if (entry_key == key)
+		return true;
+	if (entry_key == NULL)
+		return false;
+	Class* entry_class = entry_key->class_;
+	Class* key_class = key->class_;
+	if (entry_class == &String_class || key_class == &String_class) {
+		return
+			entry_class == key_class &&
+			String_equals((String*) entry_key, (String*) key);
 		}
+	bool entry_is_number = (entry_class == &Int_class || entry_class == &Float_class);
+	bool key_is_number = (key_class == &Int_class || key_class == &Float_class);
+	if (entry_is_number || key_is_number) {
+		if (!entry_is_number || !key_is_number)
+			return false;
+		if (entry_class == &Int_class && key_class == &Int_class)
+			return Int_value(entry_key) == Int_value(key);
+		double entry_value = (entry_class == &Int_class ? Int_value(entry_key) : Float_value(entry_key));
+		double value = (key_class == &Int_class ? Int_value(key) : Float_value(key));
+		return entry_value == value;
+		}
+	if (entry_class == &Path_class || key_class == &Path_class) {
+		return
+			entry_class == key_class &&
+			strcmp(((Path*) entry_key)->path, ((Path*) key)->path) == 0;
+		}
+	if (Object_find_method(key, &hash_string) == NULL)
+		return false;
+	Object* items[] = { entry_key };
+	Array args_array = { &Array_class, 1, 1, items };
+	return IS_TRUTHY(call_object(key, &equals_string, &args_array));
+}
 
-	self->size += 1;
-	Dict_index_t node = self->size;
-	DictNode* t = &Node(node);
-	t->key = key;
-	t->value = value;
-	return node;
+
+static void Dict_rehash(Dict* self, uint32_t num_slots)
+{
+	self->slots = (uint32_t*) alloc_mem_no_pointers(num_slots * sizeof(uint32_t));
+	memset(self->slots, 0, num_slots * sizeof(uint32_t));
+	self->num_slots = num_slots;
+	uint32_t mask = num_slots - 1;
+	for (int i = 0; i < self->num_entries; ++i) {
+		if (self->entries[i].key == NULL)
+			continue;
+		uint32_t slot = self->entries[i].hash & mask;
+		while (self->slots[slot] != 0)
+			slot = (slot + 1) & mask;
+		self->slots[slot] = i + 1;
+		}
 }
 
 
-static Dict_index_t Dict_insert(Dict* self, struct String* key, struct Object* value, Dict_index_t node)
+static void Dict_reserve(Dict* self, int size)
 {
-	if (node == 0)
-		return Dict_create_node(self, key, value);
-	DictNode* t = &Node(node);
-	// Note: "t" can be invalidated by Dict_insert().
-	int cmp = String_cmp(key, t->key);
-	if (cmp < 0) {
-		// Stupid GCC caches the address of self->tree[node], even at -O0!
-		Dict_index_t new_left = Dict_insert(self, key, value, t->left);
-		self->tree[node].left = new_left;
+	if (size > self->capacity) {
+		int new_capacity = self->capacity ? self->capacity : min_slots;
+		while (new_capacity < size)
+			new_capacity *= 2;
+		DictEntry* new_entries = (DictEntry*) alloc_mem(new_capacity * sizeof(DictEntry));
+		if (self->num_entries > 0)
+			memcpy(new_entries, self->entries, self->num_entries * sizeof(DictEntry));
+		self->entries = new_entries;
+		self->capacity = new_capacity;
 		}
-	else if (cmp > 0) {
-		Dict_index_t new_right = Dict_insert(self, key, value, t->right);
-		self->tree[node].right = new_right;
+	if ((uint64_t) size * 3 > (uint64_t) self->num_slots * 2) {
+		uint32_t num_slots = self->num_slots ? self->num_slots : min_slots;
+		while ((uint64_t) size * 3 > (uint64_t) num_slots * 2)
+			num_slots *= 2;
+		Dict_rehash(self, num_slots);
 		}
-	else
-		self->tree[node].value = value;
+}
 
-	node = Dict_skew(self, node);
-	node = Dict_split(self, node);
-	return node;
+
+static uint32_t Dict_find_slot(Dict* self, Object* key, uint32_t hash)
+{
+	// Returns the slot holding "key", or "no_slot".
+	if (self->size == 0)
+		return no_slot;
+	for (uint32_t slot = hash & (self->num_slots - 1); ; slot = (slot + 1) & (self->num_slots - 1)) {
+		uint32_t index = self->slots[slot];
+		if (index == 0)
+			return no_slot;
+		DictEntry* entry = &self->entries[index - 1];
+		if (entry->hash == hash && Dict_keys_equal(entry->key, key))
+			return slot;
+		}
 }
 
-static Dict_index_t IdentityDict_insert(Dict* self, Object* key, Object* value, Dict_index_t node)
+
+static uint32_t IdentityDict_find_slot(Dict* self, Object* key, uint32_t hash)
 {
-	if (node == 0)
-		return Dict_create_node(self, (String*) key, value);
-	DictNode* t = &Node(node);
-	// Note: "t" can be invalidated by IdentityDict_insert().
-	ptrdiff_t cmp = key - (Object*) t->key;
-	if (cmp < 0) {
-		// Stupid GCC caches the address of self->tree[node], even at -O0!
-		Dict_index_t new_left = IdentityDict_insert(self, key, value, t->left);
-		self->tree[node].left = new_left;
+	if (self->size == 0)
+		return no_slot;
+	uint32_t mask = self->num_slots - 1;
+	for (uint32_t slot = hash & mask; ; slot = (slot + 1) & mask) {
+		uint32_t index = self->slots[slot];
+		if (index == 0)
+			return no_slot;
+		if ((Object*) self->entries[index - 1].key == key)
+			return slot;
 		}
-	else if (cmp > 0) {
-		Dict_index_t new_right = IdentityDict_insert(self, key, value, t->right);
-		self->tree[node].right = new_right;
+}
+
+
+static void Dict_compact(Dict* self)
+{
+	// Squeeze out the removed entries.  If that leaves the tables mostly empty,
+	// shrink them too.
+	int needed = self->size + 1;
+	int capacity = self->capacity;
+	while (capacity > min_slots && capacity / 4 >= needed)
+		capacity /= 2;
+	DictEntry* entries = self->entries;
+	if (capacity < self->capacity)
+		entries = (DictEntry*) alloc_mem(capacity * sizeof(DictEntry));
+	int num_entries = 0;
+	for (int i = 0; i < self->num_entries; ++i) {
+		if (self->entries[i].key)
+			entries[num_entries++] = self->entries[i];
 		}
-	else
-		self->tree[node].value = value;
+	if (entries == self->entries)
+		memset(entries + num_entries, 0, (self->num_entries - num_entries) * sizeof(DictEntry));
+	self->entries = entries;
+	self->capacity = capacity;
+	self->num_entries = num_entries;
+
+	uint32_t num_slots = min_slots;
+	while ((uint64_t) needed * 3 > (uint64_t) num_slots * 2)
+		num_slots *= 2;
+	Dict_rehash(self, num_slots < self->num_slots ? num_slots : self->num_slots);
+}
+
+
+static void Dict_add_entry(Dict* self, Object* key, Object* value, uint32_t hash)
+{
+	// "key" must not already be in the Dict.
+	// If the entries are full but at least a quarter of them have been removed,
+	// reuse their space instead of growing.  Compacting only happens here, not
+	// in Dict_remove_object(), so removing entries while iterating is safe.
+	if (self->num_entries == self->capacity && (self->num_entries - self->size) * 4 >= self->num_entries)
+		Dict_compact(self);
+	Dict_reserve(self, self->num_entries + 1);
+	int index = self->num_entries++;
+	DictEntry* entry = &self->entries[index];
+	entry->key = key;
+	entry->value = value;
+	entry->hash = hash;
+	self->size += 1;
 
-	node = Dict_skew(self, node);
-	node = Dict_split(self, node);
-	return node;
+	uint32_t mask = self->num_slots - 1;
+	uint32_t slot = hash & mask;
+	while (self->slots[slot] != 0)
+		slot = (slot + 1) & mask;
+	self->slots[slot] = index + 1;
 }
 
 
@@ -155,163 +247,170 @@ Dict* new_Dict()
 
 void Dict_init(Dict* self)
 {
+	// The tables aren't allocated until something is added.
 	self->class_ = &Dict_class;
-	self->capacity = capacity_increment;
-	self->size = 0;
-	self->tree = (DictNode*) alloc_mem(self->capacity * sizeof(DictNode));
-	Node(0).left = 0;
+	self->entries = NULL;
+	self->slots = NULL;
+	self->size = self->num_entries = self->capacity = 0;
+	self->num_slots = 0;
 }
 
 
-void Dict_set_at(Dict* self, String* key, Object* value)
+static void Dict_set_at_hashed(Dict* self, Object* key, Object* value, uint32_t hash)
 {
-	Dict_index_t new_left = Dict_insert(self, key, value, Node(0).left);
-	Node(0).left = new_left;
+	uint32_t slot = Dict_find_slot(self, key, hash);
+	if (slot != no_slot)
+		self->entries[self->slots[slot] - 1].value = value;
+	else
+		Dict_add_entry(self, key, value, hash);
 }
 
-void IdentityDict_set_at(Dict* self, Object* key, Object* value)
+void Dict_set_at(Dict* self, String* key, Object* value)
 {
-	Dict_index_t new_left = IdentityDict_insert(self, key, value, Node(0).left);
-	Node(0).left = new_left;
+	Dict_set_at_hashed(self, (Object*) key, value, String_hash(key));
 }
 
+void Dict_set_at_object(Dict* self, Object* key, Object* value)
+{
+	Dict_set_at_hashed(self, key, value, Dict_hash_key(key));
+}
 
-
-struct Object* Dict_at(Dict* self, String* key)
+bool Dict_remove(Dict* self, String* key)
 {
-	if (self->size == 0)
-		return NULL;
+	return Dict_remove_object(self, (Object*) key, NULL);
+}
 
-	int node = Node(0).left;
-	while (node != 0) {
-		DictNode* t = &Node(node);
-		int cmp = String_cmp(key, t->key);
-		if (cmp < 0)
-			node = t->left;
-		else if (cmp > 0)
-			node = t->right;
-		else
-			return t->value;
+bool Dict_remove_object(Dict* self, Object* key, Object** value_out)
+{
+	if (key == NULL || self->size == 0)
+		return false;
+	uint32_t slot = Dict_find_slot(self, key, Dict_hash_key(key));
+	if (slot == no_slot)
+		return false;
+	DictEntry* entry = &self->entries[self->slots[slot] - 1];
+	if (value_out)
+		*value_out = entry->value;
+	entry->key = entry->value = NULL;
+	self->size -= 1;
+
+	// Shift later entries of the probe run back, so lookups never stop early at
+	// the slot we're emptying.
+	uint32_t mask = self->num_slots - 1;
+	uint32_t empty_slot = slot;
+	for (uint32_t next = (slot + 1) & mask; self->slots[next] != 0; next = (next + 1) & mask) {
+		uint32_t home = self->entries[self->slots[next] - 1].hash & mask;
+		if (((next - home) & mask) >= ((next - empty_slot) & mask)) {
+			self->slots[empty_slot] = self->slots[next];
+			empty_slot = next;
+			}
 		}
+	self->slots[empty_slot] = 0;
 
-	return NULL;
+	if (self->size == 0)
+		self->num_entries = 0;
+	return true;
 }
 
-
-struct String* Dict_key_at(Dict* self, struct String* key)
+void IdentityDict_set_at(Dict* self, Object* key, Object* value)
 {
-	if (self->size == 0)
-		return NULL;
+	uint32_t hash = identity_hash(key);
+	uint32_t slot = IdentityDict_find_slot(self, key, hash);
+	if (slot != no_slot)
+		self->entries[self->slots[slot] - 1].value = value;
+	else
+		Dict_add_entry(self, key, value, hash);
+}
 
-	int node = Node(0).left;
-	while (node != 0) {
-		DictNode* t = &Node(node);
-		int cmp = String_cmp(key, t->key);
-		if (cmp < 0)
-			node = t->left;
-		else if (cmp > 0)
-			node = t->right;
-		else
-			return t->key;
-		}
 
-	return NULL;
+
+struct Object* Dict_at(Dict* self, String* key)
+{
+	uint32_t slot = Dict_find_slot(self, (Object*) key, String_hash(key));
+	if (slot == no_slot)
+		return NULL;
+	return self->entries[self->slots[slot] - 1].value;
 }
 
-Object* IdentityDict_at(Dict* self, Object* key)
+Object* Dict_at_object(Dict* self, Object* key)
 {
-	if (self->size == 0)
+	if (key == NULL || self->size == 0)
 		return NULL;
+	uint32_t slot = Dict_find_slot(self, key, Dict_hash_key(key));
+	if (slot == no_slot)
+		return NULL;
+	return self->entries[self->slots[slot] - 1].value;
+}
 
-	int node = Node(0).left;
-	while (node != 0) {
-		DictNode* t = &Node(node);
-		ptrdiff_t cmp = key - (Object*) t->key;
-		if (cmp < 0)
-			node = t->left;
-		else if (cmp > 0)
-			node = t->right;
-		else
-			return t->value;
-		}
 
-	return NULL;
+struct String* Dict_key_at(Dict* self, struct String* key)
+{
+	uint32_t slot = Dict_find_slot(self, (Object*) key, String_hash(key));
+	if (slot == no_slot)
+		return NULL;
+	return (String*) self->entries[self->slots[slot] - 1].key;
 }
 
-
-static void Dict_dump_node(Dict* self, Dict_index_t node, int level)
+Object* IdentityDict_at(Dict* self, Object* key)
 {
-	DictNode* t = &Node(node);
-	for (int i = level; i > 0; --i)
-		printf("  ");
-	printf("\"%s\" (%d) [%d]\n", String_c_str(t->key), t->level, node);
-	if (t->left)
-		Dict_dump_node(self, t->left, level + 1);
-	else if (t->right) {
-		for (int i = level + 1; i > 0; --i)
-			printf("  ");
-		printf("-\n");
-		}
-	if (t->right)
-		Dict_dump_node(self, t->right, level + 1);
-	else if (t->left) {
-		for (int i = level + 1; i > 0; --i)
-			printf("  ");
-		printf("-\n");
-		}
+	uint32_t slot = IdentityDict_find_slot(self, key, identity_hash(key));
+	if (slot == no_slot)
+		return NULL;
+	return self->entries[self->slots[slot] - 1].value;
 }
 
 
 void Dict_dump(Dict* self)
 {
-	if (Node(0).left == 0)
+	if (self->size == 0) {
 		printf("Empty Dict.\n");
-	else
-		Dict_dump_node(self, Node(0).left, 0);
+		return;
+		}
+	uint32_t mask = self->num_slots - 1;
+	for (int i = 0; i < self->num_entries; ++i) {
+		DictEntry* entry = &self->entries[i];
+		if (entry->key == NULL)
+			continue;
+		// Show how far the entry had to be probed from its home slot.
+		uint32_t slot = entry->hash & mask;
+		int distance = 0;
+		while (self->slots[slot] != (uint32_t) i + 1) {
+			slot = (slot + 1) & mask;
+			distance += 1;
+			}
+		if (entry->key->class_ == &String_class)
+			printf("\"%s\"", String_c_str((String*) entry->key));
+		else
+			printf("a %s", String_c_str(entry->key->class_->name));
+		printf(" [%d] +%d\n", i, distance);
+		}
 }
 
 
 
 
-static void DictIterator_push_tree(DictIterator* self, size_t node)
-{
-	while (node) {
-		Array_append(self->stack, (Object*) node);
-		node = self->dict->tree[node].left;
-		}
-}
-
-
 DictIterator* new_DictIterator(Dict* dict)
 {
 	DictIterator* self = alloc_obj(DictIterator);
 	self->class_ = &DictIterator_class;
 	self->dict = dict;
-	self->stack = new_Array();
-
-	DictIterator_push_tree(self, dict->tree[0].left);
-
+	self->index = 0;
 	return self;
 }
 
 
 DictIteratorResult DictIterator_next(DictIterator* self)
 {
+	// Entries are returned in the order they were added.
 	DictIteratorResult result = { NULL, NULL };
-
-	if (self->stack->size == 0)
-		return result;
-
-	// Get the result.
-	DictNode* node = &self->dict->tree[(size_t) Array_back(self->stack)];
-	result.key = node->key;
-	result.value = node->value;
-
-	// Go forward.
-	int right = node->right;
-	Array_pop_back(self->stack);
-	DictIterator_push_tree(self, right);
-
+	Dict* dict = self->dict;
+	while (self->index < dict->num_entries) {
+		DictEntry* entry = &dict->entries[self->index++];
+		if (entry->key) {
+			result.key = entry->key;
+			result.value = entry->value;
+			break;
+			}
+		}
 	return result;
 }
 
@@ -322,61 +421,77 @@ typedef struct DictIteratorKeyValue {
 	} DictIteratorKeyValue;
 
 
-static Object* Dict_init_builtin(Object* super, Object** args)
+Object* Dict_init_builtin(Object* super, Object** args)
 {
 	Dict_init((Dict*) super);
 	return super;
 }
 
-static Object* Dict_at_builtin(Object* super, Object** args)
+Object* Dict_at_builtin(Object* super, Object** args)
 {
-	String* key = String_enforce(args[0], "Dict.[]");
-	return (Object*) Dict_at((Dict*) super, key);
+	return Dict_at_object((Dict*) super, args[0]);
 }
 
-static Object* Dict_set_at_builtin(Object* super, Object** args)
+Object* Dict_set_at_builtin(Object* super, Object** args)
 {
-	String* key = String_enforce(args[0], "Dict.[]=");
-	Dict_set_at((Dict*) super, key, args[1]);
+	Dict_set_at_object((Dict*) super, args[0], args[1]);
 	return args[1];
 }
 
-static Object* Dict_iterator_builtin(Object* super, Object** args)
+Object* Dict_remove_builtin(Object* super, Object** args)
+{
+	Dict_remove_object((Dict*) super, args[0], NULL);
+	return super;
+}
+
+Object* Dict_pop_builtin(Object* super, Object** args)
+{
+	Object* value = NULL;
+	if (!Dict_remove_object((Dict*) super, args[0], &value))
+		return args[1];
+	return value;
+}
+
+Object* Dict_iterator_builtin(Object* super, Object** args)
 {
 	return (Object*) new_DictIterator((Dict*) super);
 }
 
-static Object* Dict_size_builtin(Object* super, Object** args)
+Object* Dict_size_builtin(Object* super, Object** args)
 {
 	return (Object*) new_Int(((Dict*) super)->size);
 }
 
-static Object* Dict_contains_builtin(Object* super, Object** args)
+Object* Dict_contains_builtin(Object* super, Object** args)
 {
 	Dict* self = (Dict*) super;
-	String* key = String_enforce(args[0], "Dict.contains");
-	return make_bool(Dict_at(self, key) != NULL);
+	return make_bool(Dict_at_object(self, args[0]) != NULL);
 }
 
 
-static Object* DictIterator_next_builtin(Object* super, Object** args)
+Object* new_DictIteratorKeyValue(Object* key, Object* value)
 {
-	DictIteratorResult result = DictIterator_next((DictIterator*) super);
-	if (result.key == NULL)
-		return NULL;
-
 	DictIteratorKeyValue* kv = alloc_obj(DictIteratorKeyValue);
 	kv->class_ = &DictIteratorKeyValue_class;
-	kv->result = result;
+	kv->result.key = key;
+	kv->result.value = value;
 	return (Object*) kv;
 }
 
-static Object* DictIteratorKeyValue_key(Object* super, Object** args)
+Object* DictIterator_next_builtin(Object* super, Object** args)
+{
+	DictIteratorResult result = DictIterator_next((DictIterator*) super);
+	if (result.key == NULL)
+		return NULL;
+	return new_DictIteratorKeyValue(result.key, result.value);
+}
+
+Object* DictIteratorKeyValue_key(Object* super, Object** args)
 {
 	return (Object*) ((DictIteratorKeyValue*) super)->result.key;
 }
 
-static Object* DictIteratorKeyValue_value(Object* super, Object** args)
+Object* DictIteratorKeyValue_value(Object* super, Object** args)
 {
 	return ((DictIteratorKeyValue*) super)->result.value;
 }
@@ -385,31 +500,13 @@ static Object* DictIteratorKeyValue_value(Object* super, Object** args)
 void Dict_init_class()
 {
 	init_static_class(Dict);
-	static const BuiltinMethodSpec builtin_methods[] = {
-		{ "init", 0, Dict_init_builtin },
-		{ "[]", 1, Dict_at_builtin },
-		{ "[]=", 1, Dict_set_at_builtin },
-		{ "iterator", 0, Dict_iterator_builtin },
-		{ "size", 0, Dict_size_builtin },
-		{ "contains", 0, Dict_contains_builtin },
-		{ NULL },
-		};
-	Class_add_builtin_methods(&Dict_class, builtin_methods);
+	set_builtin_methods(Dict);
 
 	init_static_class(DictIterator);
-	static const BuiltinMethodSpec builtin_iterator_methods[] = {
-		{ "next", 0, DictIterator_next_builtin },
-		{ NULL },
-		};
-	Class_add_builtin_methods(&DictIterator_class, builtin_iterator_methods);
+	set_builtin_methods(DictIterator);
 
 	init_static_class(DictIteratorKeyValue);
-	static const BuiltinMethodSpec builtin_kv_methods[] = {
-		{ "key", 0, DictIteratorKeyValue_key },
-		{ "value", 0, DictIteratorKeyValue_value },
-		{ NULL },
-		};
-	Class_add_builtin_methods(&DictIteratorKeyValue_class, builtin_kv_methods);
+	set_builtin_methods(DictIteratorKeyValue);
 }
 
 
@@ -3,22 +3,41 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-struct DictNode;
 struct String;
 struct Object;
 struct Class;
 struct Array;
 
+// A hash table.  The entries are kept in the order they were added, and the
+// table of slots holds indices into them.  (GenBuiltinTables makes Dicts
+// directly, so it has to agree with Dict.c about how they're laid out.)
+
+typedef struct DictEntry {
+	struct Object* key; 	// NULL if the entry has been removed.
+	struct Object* value;
+	uint32_t hash;
+	} DictEntry;
+
 typedef struct Dict {
 	struct Class* class_;
-	struct DictNode* tree;
-	int capacity, size;
+	DictEntry* entries;
+	uint32_t* slots; 	// Entry index + 1, or zero for an empty slot.
+	int size, num_entries, capacity;
+	uint32_t num_slots;
 	} Dict;
 
 extern Dict* new_Dict();
 extern void Dict_init(Dict* self);
 extern void Dict_set_at(Dict* self, struct String* key, struct Object* value);
 extern struct Object* Dict_at(Dict* self, struct String* key);
+extern void Dict_set_at_object(Dict* self, struct Object* key, struct Object* value);
+extern struct Object* Dict_at_object(Dict* self, struct Object* key);
+extern bool Dict_remove(Dict* self, struct String* key);
+extern bool Dict_remove_object(Dict* self, struct Object* key, struct Object** value_out);
+	// Returns false if the key wasn't there.  "value_out" can be NULL.
+	// Keys can be any non-nil object.  Strings, Ints, Floats, and Paths are
+	// compared by value; other objects use their "hash" and "==" methods if they
+	// have a "hash" method, otherwise they're compared by identity.
 extern struct String* Dict_key_at(Dict* self, struct String* key);
 	// Useful to avoid proliferations of the same string.
 extern void Dict_dump(Dict* self);
@@ -28,18 +47,20 @@ extern void IdentityDict_set_at(Dict* self, struct Object* key, struct Object* v
 
 
 typedef struct DictIteratorResult {
-	struct String* key;
+	struct Object* key;
 	struct Object* value;
 	} DictIteratorResult;
 
 typedef struct DictIterator {
 	struct Class* class_;
 	struct Dict* dict;
-	struct Array* stack;
+	int index;
 	} DictIterator;
 
 struct DictIterator* new_DictIterator(Dict* dict);
 DictIteratorResult DictIterator_next(DictIterator* self);
+extern struct Object* new_DictIteratorKeyValue(struct Object* key, struct Object* value);
+	// What the iterator's "next" method returns to scripts.
 
 
 extern struct Class Dict_class;
@@ -38,12 +38,7 @@ void Env_init_class()
 {
 	init_static_class(Env);
 
-	static const BuiltinMethodSpec builtin_methods[] = {
-		{ "[]", 1, Env_at },
-		{ "as-dict", 0, Env_as_dict },
-		{ NULL },
-		};
-	Class_add_builtin_methods(&Env_class, builtin_methods);
+	set_builtin_methods(Env);
 }
 
 
@@ -9,6 +9,7 @@
 #include "Class.h"
 #include "Object.h"
 #include "Array.h"
+#include "Region.h"
 #include "Memory.h"
 #include "Error.h"
 
@@ -61,11 +62,12 @@ Class* GlobalEnvironment_get_class_for_superclass(Environment* super, String* na
 
 void GlobalEnvironment_init()
 {
+	extern Dict builtin_globals;
 	global_environment.environment.find = GlobalEnvironment_find;
 	global_environment.environment.find_autodeclaring = GlobalEnvironment_find;
 	global_environment.environment.get_class_for_superclass = GlobalEnvironment_get_class_for_superclass;
 	global_environment.environment.on_class = NULL;
-	global_environment.dict = new_Dict();
+	global_environment.dict = &builtin_globals;
 }
 
 void GlobalEnvironment_add(struct String* name, struct Object* value)
@@ -87,11 +89,6 @@ void GlobalEnvironment_add_fn(
 	GlobalEnvironment_add(new_c_static_String(name), (struct Object*) method);
 }
 
-void GlobalEnvironment_add_class(Class* the_class)
-{
-	GlobalEnvironment_add(the_class->name, (struct Object*) the_class);
-}
-
 
 
 ParseNode* MethodEnvironment_find(Environment* super, String* name)
@@ -106,7 +103,7 @@ ParseNode* MethodEnvironment_find(Environment* super, String* name)
 
 MethodEnvironment* new_MethodEnvironment(struct MethodBuilder* method, Environment* parent)
 {
-	MethodEnvironment* self = alloc_obj(MethodEnvironment);
+	MethodEnvironment* self = alloc_compiler_obj(MethodEnvironment);
 	self->environment.parent = parent;
 	self->environment.find = MethodEnvironment_find;
 	self->environment.find_autodeclaring = MethodEnvironment_find;
@@ -25,13 +25,13 @@ typedef struct GlobalEnvironment {
 	} GlobalEnvironment;
 extern GlobalEnvironment global_environment;
 extern void GlobalEnvironment_init();
+	// Starts with the bindings in BuiltinTables.def.
 extern void GlobalEnvironment_add(struct String* name, struct Object* value);
 extern void GlobalEnvironment_add_c(const char* name, struct Object* value);
 extern void GlobalEnvironment_add_fn(
 	const char* name,
 	int num_args,
 	struct Object* (*fn)(struct Object* self, struct Object** args));
-extern void GlobalEnvironment_add_class(struct Class* the_class);
 
 typedef struct MethodEnvironment {
 	Environment environment;
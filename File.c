@@ -1,5 +1,6 @@
 #include "File.h"
 #include "String.h"
+#include "StringBuilder.h"
 #include "Path.h"
 #include "LinesIterator.h"
 #include "ByteArray.h"
@@ -10,6 +11,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
+#include <sys/stat.h>
 
 Class File_class;
 
@@ -64,8 +66,13 @@ Object* File_write(Object* super, Object** args)
 		fwrite(byte_array->array, byte_array->size, 1, self->file);
 		}
 
+	else if (args[0]->class_ == &StringBuilder_class) {
+		StringBuilder* builder = (StringBuilder*) args[0];
+		fwrite(builder->buffer, builder->size, 1, self->file);
+		}
+
 	else
-		Error("File.write() needs a String or a ByteArray.");
+		Error("File.write() needs a String, a ByteArray, or a StringBuilder.");
 	
 	return super;
 }
@@ -118,16 +125,7 @@ Object* File_lines(Object* super, Object** args)
 void File_init_class()
 {
 	init_static_class(File);
-	static const BuiltinMethodSpec file_methods[] = {
-		{ "init", 2, File_init },
-		{ "write", 1, File_write },
-		{ "read", 1, File_read },
-		{ "flush", 0, File_flush },
-		{ "close", 0, File_close },
-		{ "lines", 0, File_lines },
-		{ NULL },
-		};
-	Class_add_builtin_methods(&File_class, file_methods);
+	set_builtin_methods(File);
 }
 
 
@@ -148,13 +146,31 @@ String* file_contents(const char* file_path)
 	FILE* file = fopen(file_path, "r");
 	if (file == NULL)
 		return NULL;
-	fseek(file, 0, SEEK_END);
-	size_t size = ftell(file);
-	rewind(file);
-	char* text = (char*) alloc_mem(size);
+	// fopen() succeeds on directories, and ftell() doesn't work on pipes, so get
+	// the size from fstat() and insist on a regular file.
+	struct stat stat_buf;
+	if (fstat(fileno(file), &stat_buf) < 0) {
+		fclose(file);
+		return NULL;
+		}
+	if (!S_ISREG(stat_buf.st_mode)) {
+		fclose(file);
+		errno = (S_ISDIR(stat_buf.st_mode) ? EISDIR : EINVAL);
+		return NULL;
+		}
+	size_t size = stat_buf.st_size;
+	char* text = (char*) alloc_mem(size + 1);
+	if (text == NULL) {
+		fclose(file);
+		errno = ENOMEM;
+		return NULL;
+		}
 	size_t bytes_read = fread(text, 1, size, file);
 	fclose(file);
-	return new_static_String(text, bytes_read);
+	text[bytes_read] = 0;
+	String* result = new_static_String(text, bytes_read);
+	result->is_c_str = true;
+	return result;
 }
 
 
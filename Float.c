@@ -7,6 +7,7 @@
 #include "Boolean.h"
 #include "Memory.h"
 #include "UTF8.h"
+#include "Numbers.h"
 #include "Error.h"
 #include <stdio.h>
 
@@ -45,9 +46,8 @@ Object* Float_init(Object* super, Object** args)
 	else if (args[0]->class_ == &Int_class)
 		self->value = Int_value(args[0]);
 	else if (args[0]->class_ == &String_class) {
-		char* end_ptr = NULL;
-		self->value = strtod(String_c_str((String*) args[0]), &end_ptr);
-		if (*end_ptr != 0)
+		String* str = (String*) args[0];
+		if (!parse_float(str->str, str->size, &self->value))
 			Error("Invalid conversion from string \"%s\" to Float.", String_c_str((String*) args[0]));
 		}
 	else
@@ -57,9 +57,9 @@ Object* Float_init(Object* super, Object** args)
 
 Object* Float_string(Object* super, Object** args)
 {
-	char str[64];
-	snprintf(str, sizeof(str), "%g", ((Float*) super)->value);
-	return (Object*) new_c_String(str);
+	char str[max_formatted_float_size];
+	int size = format_float(((Float*) super)->value, str);
+	return (Object*) new_String(str, size);
 }
 
 Object* Float_plus(Object* super, Object** args)
@@ -138,22 +138,7 @@ void Float_init_class()
 {
 	init_static_class(Float);
 
-	BuiltinMethodSpec builtin_methods[] = {
-		{ "init", 1, Float_init },
-		{ "string", 0, Float_string },
-		{ "+", 1, Float_plus },
-		{ "-", 1, Float_minus },
-		{ "*", 1, Float_times },
-		{ "/", 1, Float_divide },
-		{ "==", 1, Float_equals },
-		{ "!=", 1, Float_not_equals },
-		{ "<", 1, Float_less_than },
-		{ ">", 1, Float_greater_than },
-		{ "<=", 1, Float_less_than_or_equal },
-		{ ">=", 1, Float_greater_than_or_equal },
-		{ NULL },
-		};
-	Class_add_builtin_methods(&Float_class, builtin_methods);
+	set_builtin_methods(Float);
 }
 
 
@@ -0,0 +1,333 @@
+// Makes objects/BuiltinTables.c from BuiltinTables.def, at build time.
+// Usage: GenBuiltinTables BuiltinTables.def > BuiltinTables.c  (or from stdin)
+//
+// Each table becomes a static Dict, laid out just as Dict.c would lay it out
+// after adding the entries in order, with the names' hashes already computed.
+// This is a standalone program (it doesn't link with the rest of sqs), so
+// "hash_name()" and "num_slots_for()" have to match String_hash_c() and
+// Dict_reserve().
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <ctype.h>
+
+#define max_line 1024
+#define max_entries 256
+#define max_tables 64
+#define max_functions 4096
+#define max_includes 64
+#define min_slots 8
+
+typedef struct Entry {
+	char* name;
+	int num_args;
+	char* function; 	// NULL if it's not a function.
+	char* value; 	// C expression, if it's not a function.
+	bool is_class; 	// "value" is "&<name>_class".
+	} Entry;
+
+typedef struct Table {
+	char* name; 	// The C identifiers are made from this.
+	Entry entries[max_entries];
+	int num_entries;
+	} Table;
+
+static const char* def_path = "BuiltinTables.def";
+static int line_number = 0;
+static char* functions[max_functions];
+static int num_functions = 0;
+static char* includes[max_includes];
+static int num_includes = 0;
+
+
+static void fail(const char* message)
+{
+	fprintf(stderr, "%s:%d: %s\n", def_path, line_number, message);
+	exit(1);
+}
+
+
+static char* copy_string(const char* str)
+{
+	char* copy = strdup(str);
+	if (copy == NULL)
+		fail("Out of memory.");
+	return copy;
+}
+
+
+static uint32_t hash_name(const char* name)
+{
+	// FNV-1a, like String_hash_c().
+	uint32_t hash = 2166136261U;
+	for (const uint8_t* p = (const uint8_t*) name; *p; ++p) {
+		hash ^= *p;
+		hash *= 16777619U;
+		}
+	if (hash == 0)
+		hash = 1;
+	return hash;
+}
+
+
+static uint32_t num_slots_for(int size)
+{
+	// Like Dict_reserve(): at most 2/3 full.
+	uint32_t num_slots = min_slots;
+	while ((uint64_t) size * 3 > (uint64_t) num_slots * 2)
+		num_slots *= 2;
+	return num_slots;
+}
+
+
+static void add_function(const char* function)
+{
+	for (int i = 0; i < num_functions; ++i) {
+		if (strcmp(functions[i], function) == 0)
+			return;
+		}
+	if (num_functions >= max_functions)
+		fail("Too many functions.");
+	functions[num_functions++] = copy_string(function);
+}
+
+
+static void write_c_string(const char* str, FILE* out)
+{
+	fputc('"', out);
+	for (const char* p = str; *p; ++p) {
+		if (*p == '"' || *p == '\\')
+			fputc('\\', out);
+		fputc(*p, out);
+		}
+	fputc('"', out);
+}
+
+
+static void write_table(Table* table, bool is_global, FILE* out)
+{
+	const char* prefix = table->name;
+	int size = table->num_entries;
+	fprintf(out, "\n// %s\n", is_global ? "Globals" : prefix);
+
+	fprintf(out, "static String %s_names[] = {\n", prefix);
+	for (int i = 0; i < size; ++i) {
+		Entry* entry = &table->entries[i];
+		fprintf(out, "\t{ .class_ = &String_class, .str = ");
+		write_c_string(entry->name, out);
+		fprintf(out,
+			", .size = %d, .hash = 0x%08XU, .is_c_str = true },\n",
+			(int) strlen(entry->name), hash_name(entry->name));
+		}
+	fprintf(out, "\t};\n");
+
+	int num_methods = 0;
+	for (int i = 0; i < size; ++i) {
+		if (table->entries[i].function)
+			num_methods += 1;
+		}
+	if (num_methods > 0) {
+		fprintf(out, "static BuiltinMethod %s_methods[] = {\n", prefix);
+		for (int i = 0; i < size; ++i) {
+			Entry* entry = &table->entries[i];
+			if (entry->function)
+				fprintf(out, "\t{ &BuiltinMethod_class, %d, %s },\n", entry->num_args, entry->function);
+			}
+		fprintf(out, "\t};\n");
+		}
+
+	fprintf(out, "static DictEntry %s_entries[] = {\n", prefix);
+	int method_index = 0;
+	for (int i = 0; i < size; ++i) {
+		Entry* entry = &table->entries[i];
+		fprintf(out, "\t{ (Object*) &%s_names[%d], ", prefix, i);
+		if (entry->function)
+			fprintf(out, "(Object*) &%s_methods[%d]", prefix, method_index++);
+		else
+			fprintf(out, "(Object*) (%s)", entry->value);
+		fprintf(out, ", 0x%08XU },\n", hash_name(entry->name));
+		}
+	fprintf(out, "\t};\n");
+
+	// The slots, probed linearly from the hash, as Dict.c does.
+	uint32_t num_slots = num_slots_for(size);
+	uint32_t* slots = calloc(num_slots, sizeof(uint32_t));
+	if (slots == NULL)
+		fail("Out of memory.");
+	for (int i = 0; i < size; ++i) {
+		uint32_t slot = hash_name(table->entries[i].name) & (num_slots - 1);
+		while (slots[slot] != 0)
+			slot = (slot + 1) & (num_slots - 1);
+		slots[slot] = i + 1;
+		}
+	fprintf(out, "static uint32_t %s_slots[] = {", prefix);
+	for (uint32_t i = 0; i < num_slots; ++i)
+		fprintf(out, "%s%u,", (i % 16 == 0 ? "\n\t" : " "), slots[i]);
+	fprintf(out, "\n\t};\n");
+	free(slots);
+
+	fprintf(out,
+		"Dict %s%s = {\n"
+		"\t.class_ = &Dict_class,\n"
+		"\t.entries = %s_entries, .slots = %s_slots,\n"
+		"\t.size = %d, .num_entries = %d, .capacity = %d,\n"
+		"\t.num_slots = %u,\n"
+		"\t};\n",
+		prefix, is_global ? "" : "_builtin_methods",
+		prefix, prefix,
+		size, size, size,
+		num_slots);
+}
+
+
+static char* next_word(char** line)
+{
+	// Splits off the next whitespace-delimited word, or returns NULL.
+	char* p = *line;
+	while (isspace((unsigned char) *p))
+		p += 1;
+	if (*p == 0)
+		return NULL;
+	char* word = p;
+	while (*p && !isspace((unsigned char) *p))
+		p += 1;
+	if (*p)
+		*p++ = 0;
+	*line = p;
+	return word;
+}
+
+
+static void parse_entry(Table* table, char* line)
+{
+	if (table->num_entries >= max_entries)
+		fail("Too many entries.");
+	Entry* entry = &table->entries[table->num_entries];
+	char* name = next_word(&line);
+	char* second = next_word(&line);
+	if (name == NULL || second == NULL)
+		fail("Incomplete entry.");
+	for (int i = 0; i < table->num_entries; ++i) {
+		if (strcmp(table->entries[i].name, name) == 0)
+			fail("Duplicate name.");
+		}
+	entry->name = copy_string(name);
+	entry->function = entry->value = NULL;
+	entry->is_class = false;
+
+	if (strcmp(second, "=") == 0) {
+		while (isspace((unsigned char) *line))
+			line += 1;
+		if (*line == 0)
+			fail("Missing value.");
+		entry->value = copy_string(line);
+		}
+	else if (strcmp(second, "class") == 0) {
+		size_t size = strlen(name) + 8;
+		entry->value = malloc(size);
+		if (entry->value == NULL)
+			fail("Out of memory.");
+		snprintf(entry->value, size, "&%s_class", name);
+		entry->is_class = true;
+		}
+	else {
+		char* end = NULL;
+		entry->num_args = strtol(second, &end, 10);
+		char* function = next_word(&line);
+		if (*end != 0 || function == NULL || next_word(&line) != NULL)
+			fail("Expected \"<name> <num-args> <function>\".");
+		entry->function = copy_string(function);
+		add_function(function);
+		}
+	table->num_entries += 1;
+}
+
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1)
+		def_path = argv[1];
+	FILE* in = (argc > 1 ? fopen(def_path, "r") : stdin);
+	if (in == NULL)
+		fail("Couldn't open it.");
+
+	// Read all the tables first, so the function declarations can go before
+	// them.
+	static Table tables[max_tables];
+	int num_tables = 0;
+	Table* table = NULL;
+	int globals_index = -1;
+	char line[max_line];
+	while (fgets(line, sizeof(line), in)) {
+		line_number += 1;
+		line[strcspn(line, "\n")] = 0;
+		if (line[0] == '#' || line[strspn(line, " \t")] == 0)
+			continue;
+		if (isspace((unsigned char) line[0])) {
+			if (table == NULL)
+				fail("Entry outside of a table.");
+			parse_entry(table, line);
+			continue;
+			}
+		char* rest = line;
+		char* keyword = next_word(&rest);
+		char* name = next_word(&rest);
+		if (strcmp(keyword, "include") == 0 && name) {
+			if (num_includes >= max_includes)
+				fail("Too many includes.");
+			includes[num_includes++] = copy_string(name);
+			continue;
+			}
+		if (num_tables >= max_tables)
+			fail("Too many tables.");
+		if (strcmp(keyword, "class") == 0 && name) {
+			table = &tables[num_tables++];
+			table->name = copy_string(name);
+			}
+		else if (strcmp(keyword, "globals") == 0 && name == NULL) {
+			if (globals_index >= 0)
+				fail("Globals given twice.");
+			globals_index = num_tables;
+			table = &tables[num_tables++];
+			table->name = copy_string("builtin_globals");
+			}
+		else
+			fail("Expected \"class <Name>\", \"globals\", or \"include <header>\".");
+		}
+	if (in != stdin)
+		fclose(in);
+
+	FILE* out = stdout;
+	fprintf(out, "// Made from %s by GenBuiltinTables.  Don't edit it.\n\n", def_path);
+	fprintf(out, "#include \"Dict.h\"\n");
+	fprintf(out, "#include \"String.h\"\n");
+	fprintf(out, "#include \"Class.h\"\n");
+	fprintf(out, "#include \"BuiltinMethod.h\"\n");
+	fprintf(out, "#include \"Object.h\"\n");
+	for (int i = 0; i < num_includes; ++i)
+		fprintf(out, "#include \"%s\"\n", includes[i]);
+	fprintf(out, "#include <stdbool.h>\n\n");
+	if (globals_index >= 0) {
+		Table* globals = &tables[globals_index];
+		for (int i = 0; i < globals->num_entries; ++i) {
+			if (globals->entries[i].is_class)
+				fprintf(out, "extern Class %s_class;\n", globals->entries[i].name);
+			}
+		fprintf(out, "\n");
+		}
+	for (int i = 0; i < num_functions; ++i)
+		fprintf(out, "extern Object* %s(Object* self, Object** args);\n", functions[i]);
+
+	for (int i = 0; i < num_tables; ++i)
+		write_table(&tables[i], i == globals_index, out);
+
+	if (ferror(out) || fflush(out) != 0) {
+		fprintf(stderr, "GenBuiltinTables: couldn't write the output.\n");
+		return 1;
+		}
+	return 0;
+}
+
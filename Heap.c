@@ -0,0 +1,196 @@
+#include "Heap.h"
+#include "Dict.h"
+#include "Array.h"
+#include "String.h"
+#include "Class.h"
+#include "Object.h"
+#include "Boolean.h"
+#include "Int.h"
+#include "Float.h"
+#include "Memory.h"
+#include "Error.h"
+#include <string.h>
+
+typedef struct HeapEntry {
+	struct Object* key;
+	struct Object* item;
+	uint64_t order;
+	} HeapEntry;
+
+#define min_capacity 16
+
+Class Heap_class;
+
+
+declare_static_string(less_than_string, "<");
+
+static bool key_less(Object* a, Object* b)
+{
+	// Ints, Floats, and Strings are compared without calling "<".
+	if (a == NULL)
+		Error("Heap keys can't be nil.");
+	Class* a_class = a->class_;
+	Class* b_class = (b ? b->class_ : NULL);
+	if (a_class == &Int_class && b_class == &Int_class)
+		return Int_value(a) < Int_value(b);
+	if (a_class == &String_class && b_class == &String_class)
+		return String_cmp((String*) a, (String*) b) < 0;
+	if ((a_class == &Int_class || a_class == &Float_class) && (b_class == &Int_class || b_class == &Float_class)) {
+		double a_value = (a_class == &Int_class ? Int_value(a) : Float_value(a));
+		double b_value = (b_class == &Int_class ? Int_value(b) : Float_value(b));
+		return a_value < b_value;
+		}
+	Object* items[] = { b };
+	Array args_array = { &Array_class, 1, 1, items };
+	return IS_TRUTHY(call_object(a, &less_than_string, &args_array));
+}
+
+static bool Heap_entry_before(Heap* self, HeapEntry* a, HeapEntry* b)
+{
+	if (self->reverse ? key_less(b->key, a->key) : key_less(a->key, b->key))
+		return true;
+	if (self->reverse ? key_less(a->key, b->key) : key_less(b->key, a->key))
+		return false;
+	return a->order < b->order;
+}
+
+
+Heap* new_Heap()
+{
+	Heap* self = alloc_obj(Heap);
+	Heap_init(self, NULL, false);
+	return self;
+}
+
+
+void Heap_init(Heap* self, Object* key, bool reverse)
+{
+	self->class_ = &Heap_class;
+	self->entries = NULL;
+	self->size = self->capacity = 0;
+	self->next_order = 0;
+	self->has_key = (key != NULL);
+	self->reverse = reverse;
+	if (key)
+		Callback_init(&self->key, key, "Heap");
+}
+
+
+void Heap_push(Heap* self, Object* item)
+{
+	// The key is computed once, when the item is pushed.
+	Object* key = (self->has_key ? Callback_call(&self->key, item, NULL, 0) : item);
+	if (key == NULL)
+		Error("Heap keys can't be nil.");
+
+	if (self->size >= self->capacity) {
+		int new_capacity = (self->capacity ? self->capacity * 2 : min_capacity);
+		HeapEntry* new_entries = (HeapEntry*) alloc_mem(new_capacity * sizeof(HeapEntry));
+		if (self->size > 0)
+			memcpy(new_entries, self->entries, self->size * sizeof(HeapEntry));
+		self->entries = new_entries;
+		self->capacity = new_capacity;
+		}
+
+	// Sift up.
+	HeapEntry entry = { key, item, self->next_order++ };
+	int index = self->size++;
+	while (index > 0) {
+		int parent = (index - 1) / 2;
+		if (!Heap_entry_before(self, &entry, &self->entries[parent]))
+			break;
+		self->entries[index] = self->entries[parent];
+		index = parent;
+		}
+	self->entries[index] = entry;
+}
+
+
+Object* Heap_pop(Heap* self)
+{
+	if (self->size == 0)
+		return NULL;
+	Object* result = self->entries[0].item;
+
+	// Sift the last entry down from the top.
+	HeapEntry entry = self->entries[--self->size];
+	memset(&self->entries[self->size], 0, sizeof(HeapEntry));
+	int size = self->size;
+	if (size == 0)
+		return result;
+	int index = 0;
+	while (true) {
+		int child = index * 2 + 1;
+		if (child >= size)
+			break;
+		if (child + 1 < size && Heap_entry_before(self, &self->entries[child + 1], &self->entries[child]))
+			child += 1;
+		if (!Heap_entry_before(self, &self->entries[child], &entry))
+			break;
+		self->entries[index] = self->entries[child];
+		index = child;
+		}
+	self->entries[index] = entry;
+	return result;
+}
+
+
+Object* Heap_peek(Heap* self)
+{
+	if (self->size == 0)
+		return NULL;
+	return self->entries[0].item;
+}
+
+
+declare_static_string(key_string, "key");
+declare_static_string(reverse_string, "reverse");
+
+Object* Heap_init_builtin(Object* super, Object** args)
+{
+	Object* key = NULL;
+	bool reverse = false;
+	Dict* options = (Dict*) args[0];
+	if (options) {
+		if (options->class_ != &Dict_class)
+			Error("Heap: options must be a Dict.");
+		key = Dict_at(options, &key_string);
+		reverse = Dict_option_turned_on(options, &reverse_string);
+		}
+	Heap_init((Heap*) super, key, reverse);
+	return super;
+}
+
+Object* Heap_push_builtin(Object* super, Object** args)
+{
+	Heap_push((Heap*) super, args[0]);
+	return super;
+}
+
+Object* Heap_pop_builtin(Object* super, Object** args)
+{
+	return Heap_pop((Heap*) super);
+}
+
+Object* Heap_peek_builtin(Object* super, Object** args)
+{
+	return Heap_peek((Heap*) super);
+}
+
+Object* Heap_size_builtin(Object* super, Object** args)
+{
+	return (Object*) new_Int(((Heap*) super)->size);
+}
+
+Object* Heap_is_empty_builtin(Object* super, Object** args)
+{
+	return make_bool(((Heap*) super)->size == 0);
+}
+
+
+void Heap_init_class()
+{
+	init_static_class(Heap);
+	set_builtin_methods(Heap);
+}
+
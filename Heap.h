@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ByteCode.h"
+
+struct Class;
+struct Object;
+struct HeapEntry;
+
+// A priority queue, as a binary heap.  "pop" returns the item with the least
+// key (or the greatest, if "reverse").  Items with equal keys come out in the
+// order they were pushed.
+
+typedef struct Heap {
+	struct Class* class_;
+	struct HeapEntry* entries;
+	int size, capacity;
+	uint64_t next_order;
+	bool has_key, reverse;
+	Callback key;
+	} Heap;
+
+extern Heap* new_Heap();
+extern void Heap_init(Heap* self, struct Object* key, bool reverse);
+	// "key" is as for Array_sort(), and can be NULL.
+extern void Heap_push(Heap* self, struct Object* item);
+extern struct Object* Heap_pop(Heap* self);
+extern struct Object* Heap_peek(Heap* self);
+
+extern struct Class Heap_class;
+extern void Heap_init_class();
+
@@ -2,27 +2,28 @@
 #include "Object.h"
 #include "Class.h"
 #include "String.h"
+#include "StringBuilder.h"
 #include "Int.h"
 #include "Float.h"
 #include "Boolean.h"
 #include "Array.h"
 #include "ByteArray.h"
+#include "NumberArray.h"
 #include "Dict.h"
+#include "Set.h"
+#include "SortedDict.h"
+#include "Heap.h"
 #include "Nil.h"
 #include "Method.h"
 #include "BuiltinMethod.h"
 #include "Environment.h"
-#include "Print.h"
 #include "Run.h"
 #include "Pipe.h"
-#include "Glob.h"
 #include "File.h"
 #include "LinesIterator.h"
 #include "Regex.h"
 #include "Path.h"
 #include "Env.h"
-#include "MiscFunctions.h"
-#include "Fail.h"
 
 
 void init_all()
@@ -35,7 +36,12 @@ void init_all()
 	Boolean_init_class();
 	Array_init_class();
 	ByteArray_init_class();
+	StringBuilder_init_class();
+	NumberArray_init_classes();
 	Dict_init_class();
+	Set_init_class();
+	SortedDict_init_class();
+	Heap_init_class();
 	Method_init_class();
 	BuiltinMethod_init_class();
 	Nil_init_class();
@@ -49,27 +55,6 @@ void init_all()
 	Run_init();
 
 	GlobalEnvironment_init();
-	GlobalEnvironment_add_fn("print", 2, Print);
-	GlobalEnvironment_add_fn("run", 2, Run);
-	GlobalEnvironment_add_fn("glob", 2, Glob);
-	GlobalEnvironment_add_fn("sleep", 1, Sleep);
-	GlobalEnvironment_add_fn("getpid", 1, Getpid);
-	GlobalEnvironment_add_fn("fail", 1, Fail);
-	GlobalEnvironment_add_fn("cwd", 0, Get_cwd);
-	GlobalEnvironment_add_fn("chdir", 1, Chdir);
-	GlobalEnvironment_add_fn("rename", 2, Rename);
-	GlobalEnvironment_add_fn("symlink", 2, Symlink);
-	GlobalEnvironment_add_class(&Array_class);
-	GlobalEnvironment_add_class(&ByteArray_class);
-	GlobalEnvironment_add_class(&Dict_class);
-	GlobalEnvironment_add_class(&String_class);
-	GlobalEnvironment_add_class(&Int_class);
-	GlobalEnvironment_add_class(&Float_class);
-	GlobalEnvironment_add_class(&File_class);
-	GlobalEnvironment_add_class(&Pipe_class);
-	GlobalEnvironment_add_class(&Regex_class);
-	GlobalEnvironment_add_class(&Path_class);
-	GlobalEnvironment_add_c("env", (Object*) &env_obj);
 }
 
 
@@ -6,6 +6,7 @@
 #include "Boolean.h"
 #include "Memory.h"
 #include "UTF8.h"
+#include "Numbers.h"
 #include "Error.h"
 #include <stdio.h>
 
@@ -39,9 +40,8 @@ Object* Int_init(Object* super, Object** args)
 	else if (args[0]->class_ == &Int_class)
 		self->value = ((Int*) args[0])->value;
 	else if (args[0]->class_ == &String_class) {
-		char* end_ptr = NULL;
-		self->value = strtol(String_c_str((String*) args[0]), &end_ptr, 0);
-		if (*end_ptr != 0)
+		String* str = (String*) args[0];
+		if (!parse_int(str->str, str->size, &self->value))
 			Error("Invalid conversion from string \"%s\" to Int.", String_c_str((String*) args[0]));
 		}
 	else
@@ -51,9 +51,9 @@ Object* Int_init(Object* super, Object** args)
 
 Object* Int_string(Object* super, Object** args)
 {
-	char str[64];
-	snprintf(str, sizeof(str), "%d", ((Int*) super)->value);
-	return (Object*) new_c_String(str);
+	char str[max_formatted_int_size];
+	int size = format_int(((Int*) super)->value, str);
+	return (Object*) new_String(str, size);
 }
 
 Object* Int_plus(Object* super, Object** args)
@@ -177,30 +177,7 @@ void Int_init_class()
 {
 	init_static_class(Int);
 
-	BuiltinMethodSpec builtin_methods[] = {
-		{ "init", 1, Int_init },
-		{ "string", 0, Int_string },
-		{ "+", 1, Int_plus },
-		{ "-", 1, Int_minus },
-		{ "*", 1, Int_times },
-		{ "/", 1, Int_divide },
-		{ "%", 1, Int_mod },
-		{ "|", 1, Int_or },
-		{ "^", 1, Int_exclusive_or },
-		{ "&", 1, Int_and },
-		{ "~", 0, Int_not },
-		{ "==", 1, Int_equals },
-		{ "!=", 1, Int_not_equals },
-		{ "<", 1, Int_less_than },
-		{ ">", 1, Int_greater_than },
-		{ "<=", 1, Int_less_than_or_equal },
-		{ ">=", 1, Int_greater_than_or_equal },
-		{ "<<", 1, Int_left_shift },
-		{ ">>", 1, Int_right_shift },
-		{ "as-utf8", 0, Int_as_utf8 },
-		{ NULL },
-		};
-	Class_add_builtin_methods(&Int_class, builtin_methods);
+	set_builtin_methods(Int);
 }
 
 
@@ -1,7 +1,10 @@
 #include "Lexer.h"
+#include "Region.h"
 #include "Memory.h"
 #include "Error.h"
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
 
 #define indent_stack_max 64
 
@@ -12,7 +15,7 @@ extern bool Lexer_skip_comment(struct Lexer* self);
 
 Lexer* new_Lexer(const char* text, size_t size, String* filename)
 {
-	Lexer* lexer = (Lexer*) alloc_mem(sizeof(Lexer));
+	Lexer* lexer = alloc_compiler_obj(Lexer);
 	Lexer_init(lexer, text, size, filename);
 	return lexer;
 }
@@ -29,6 +32,8 @@ void Lexer_init(Lexer* self, const char* text, size_t size, String* filename)
 	self->unindent_to = -1;
 	self->have_peeked_token = false;
 	self->filename = filename;
+	self->tokens = NULL;
+	self->num_tokens = self->next_token = 0;
 }
 
 
@@ -64,8 +69,100 @@ static bool is_identifier_character(char c)
 }
 
 
+// Keywords are found with a perfect hash, worked out ahead of time: no two
+// keywords land in the same slot, so an identifier needs at most one compare.
+#define keyword_hash(str, size) ((((uint8_t) (str)[0]) * 6 + (uint8_t) (str)[(size) - 1] + (size)) & 63)
+typedef struct Keyword {
+	const char* name;
+	size_t size;
+	TokenKind kind;
+	} Keyword;
+static const Keyword keywords[64] = {
+	[30] = { "if", 2, K_IF },
+	[7] = { "else", 4, K_ELSE },
+	[8] = { "elif", 4, K_ELIF },
+	[52] = { "while", 5, K_WHILE },
+	[25] = { "for", 3, K_FOR },
+	[63] = { "continue", 8, K_CONTINUE },
+	[60] = { "break", 5, K_BREAK },
+	[32] = { "return", 6, K_RETURN },
+	[54] = { "with", 4, K_WITH },
+	[20] = { "fn", 2, K_FN },
+	[10] = { "class", 5, K_CLASS },
+	[48] = { "import", 6, K_IMPORT },
+	[24] = { "export", 6, K_EXPORT },
+	[33] = { "true", 4, K_TRUE },
+	[14] = { "false", 5, K_FALSE },
+	[3] = { "nil", 3, K_NIL },
+	[28] = { "self", 4, K_SELF },
+	[41] = { "super", 5, K_SUPER },
+	[61] = { "$", 1, K_DOLLAR },
+	};
+
+static TokenKind keyword_kind(const char* str, size_t size)
+{
+	const Keyword* keyword = &keywords[keyword_hash(str, size)];
+	if (keyword->size == size && memcmp(keyword->name, str, size) == 0)
+		return keyword->kind;
+	return K_NONE;
+}
+
+
+static TokenKind operator_kind(const char* str, size_t size)
+{
+	// Operators are at most three characters, so just look at them.
+	char second = (size > 1 ? str[1] : 0);
+	switch (str[0]) {
+		case '(': return K_LPAREN;
+		case ')': return K_RPAREN;
+		case '[': return K_LBRACKET;
+		case ']': return K_RBRACKET;
+		case '{': return K_LBRACE;
+		case '}': return K_RBRACE;
+		case '.': return K_DOT;
+		case ',': return K_COMMA;
+		case ':': return K_COLON;
+		case '~': return K_TILDE;
+		case '=': return (second == '=' ? K_EQ : K_ASSIGN);
+		case '!': return (second == '=' ? K_NE : K_NOT);
+		case '+': return (second == '=' ? K_PLUS_ASSIGN : K_PLUS);
+		case '-': return (second == '=' ? K_MINUS_ASSIGN : K_MINUS);
+		case '*': return (second == '=' ? K_TIMES_ASSIGN : K_TIMES);
+		case '/': return (second == '=' ? K_DIVIDE_ASSIGN : K_DIVIDE);
+		case '%': return (second == '=' ? K_MOD_ASSIGN : K_MOD);
+		case '^': return (second == '=' ? K_XOR_ASSIGN : K_XOR);
+		case '<':
+			if (second == '<')
+				return (size == 3 ? K_SHL_ASSIGN : K_SHL);
+			return (second == '=' ? K_LE : K_LT);
+		case '>':
+			if (second == '>')
+				return (size == 3 ? K_SHR_ASSIGN : K_SHR);
+			return (second == '=' ? K_GE : K_GT);
+		case '&':
+			if (second == '&')
+				return K_AND;
+			return (second == '=' ? K_AND_ASSIGN : K_BIT_AND);
+		case '|':
+			if (second == '|')
+				return K_OR;
+			return (second == '=' ? K_OR_ASSIGN : K_BIT_OR);
+		}
+	return K_NONE;
+}
+
+
 Token Lexer_next_token(struct Lexer* self)
 {
+	if (self->tokens) {
+		// Already lexed.  The last token is the EndOfText, which we keep
+		// returning.
+		Token token = self->tokens[self->next_token];
+		if (self->next_token + 1 < self->num_tokens)
+			self->next_token += 1;
+		return token;
+		}
+
 	Token result = { EndOfText, NULL, self->line_number };
 
 	// End of text.
@@ -366,7 +463,12 @@ Token Lexer_next_token(struct Lexer* self)
 			break;
 		}
 
-	result.token = new_String(token_start, self->p - token_start);
+	size_t size = self->p - token_start;
+	if (result.type == Identifier)
+		result.kind = keyword_kind(token_start, size);
+	else if (result.type == Operator)
+		result.kind = operator_kind(token_start, size);
+	result.token = new_String(token_start, size);
 	return result;
 }
 
@@ -398,4 +500,38 @@ void Lexer_set_for_expression(Lexer* self)
 }
 
 
+void Lexer_lex_all(Lexer* self)
+{
+	size_t capacity = 1024;
+	Token* tokens = (Token*) alloc_mem(capacity * sizeof(Token));
+	size_t num_tokens = 0;
+	if (self->have_peeked_token) {
+		tokens[num_tokens++] = self->peeked_token;
+		self->have_peeked_token = false;
+		}
+	while (num_tokens == 0 || tokens[num_tokens - 1].type != EndOfText) {
+		if (num_tokens == capacity) {
+			Token* new_tokens = (Token*) alloc_mem(capacity * 2 * sizeof(Token));
+			memcpy(new_tokens, tokens, num_tokens * sizeof(Token));
+			tokens = new_tokens;
+			capacity *= 2;
+			}
+		tokens[num_tokens++] = Lexer_next_token(self);
+		}
+	self->tokens = tokens;
+	self->num_tokens = num_tokens;
+	self->next_token = 0;
+}
+
+
+bool TokenKind_is_one_of(TokenKind kind, const TokenKind* kinds)
+{
+	for (; *kinds != K_NONE; ++kinds) {
+		if (kind == *kinds)
+			return true;
+		}
+	return false;
+}
+
+
 
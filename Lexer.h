@@ -4,6 +4,28 @@
 #include <stdbool.h>
 
 
+// Keywords and operators are recognized by the lexer, so the parser doesn't
+// need to do string compares.  Keywords are still Identifiers, since they
+// can also be used as names in some places (like method names).
+typedef enum TokenKind {
+	K_NONE,
+
+	// Keywords.
+	K_IF, K_ELSE, K_ELIF, K_WHILE, K_FOR, K_CONTINUE, K_BREAK, K_RETURN,
+	K_WITH, K_FN, K_CLASS, K_IMPORT, K_EXPORT,
+	K_TRUE, K_FALSE, K_NIL, K_SELF, K_SUPER, K_DOLLAR,
+
+	// Operators.
+	K_LPAREN, K_RPAREN, K_LBRACKET, K_RBRACKET, K_LBRACE, K_RBRACE,
+	K_DOT, K_COMMA, K_COLON, K_TILDE,
+	K_ASSIGN, K_EQ, K_NOT, K_NE,
+	K_PLUS, K_PLUS_ASSIGN, K_MINUS, K_MINUS_ASSIGN,
+	K_TIMES, K_TIMES_ASSIGN, K_DIVIDE, K_DIVIDE_ASSIGN, K_MOD, K_MOD_ASSIGN,
+	K_XOR, K_XOR_ASSIGN,
+	K_LT, K_LE, K_SHL, K_SHL_ASSIGN, K_GT, K_GE, K_SHR, K_SHR_ASSIGN,
+	K_BIT_AND, K_AND, K_AND_ASSIGN, K_BIT_OR, K_OR, K_OR_ASSIGN,
+	} TokenKind;
+
 typedef struct Token {
 	enum {
 		EndOfText, EOL,
@@ -13,6 +35,7 @@ typedef struct Token {
 		} type;
 	String* token;
 	size_t line_number;
+	TokenKind kind; 	// K_NONE unless it's a keyword or operator.
 	} Token;
 
 typedef struct Lexer {
@@ -27,6 +50,8 @@ typedef struct Lexer {
 	Token peeked_token;
 	bool have_peeked_token;
 	String* filename;
+	Token* tokens; 	// If all the text was lexed up front, by Lexer_lex_all().
+	size_t num_tokens, next_token;
 	} Lexer;
 
 extern Lexer* new_Lexer(const char* text, size_t size, String* filename);
@@ -34,4 +59,10 @@ extern Token Lexer_peek(Lexer* self);
 extern Token Lexer_next(Lexer* self);
 extern Token Lexer_next_token(Lexer* self);
 extern void Lexer_set_for_expression(Lexer* self);
+extern void Lexer_lex_all(Lexer* self);
+	// Lexes all the text now; the tokens are then handed out from memory.  This
+	// lets lexing be timed separately from parsing.
+
+extern bool TokenKind_is_one_of(TokenKind kind, const TokenKind* kinds);
+	// "kinds" is terminated by K_NONE.
 
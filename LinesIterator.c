@@ -116,11 +116,6 @@ Object* LinesIterator_next(Object* super, Object** args)
 void LinesIterator_init_class()
 {
 	init_static_class(LinesIterator);
-	static const BuiltinMethodSpec lines_methods[] = {
-		{ "next", 0, LinesIterator_next },
-		{ "iterator", 0, Object_identity },
-		{ NULL },
-		};
-	Class_add_builtin_methods(&LinesIterator_class, lines_methods);
+	set_builtin_methods(LinesIterator);
 }
 
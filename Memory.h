@@ -7,6 +7,7 @@
 #define alloc_mem(size) (GC_MALLOC(size))
 #define alloc_mem_no_pointers(size) (GC_MALLOC_ATOMIC(size))
 #define realloc_mem(ptr, size) (GC_REALLOC(ptr, size))
+#define free_mem(ptr) (GC_FREE(ptr))
 
 #define alloc_obj(Type) ((Type*) alloc_mem(sizeof(Type)))
 
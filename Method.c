@@ -1,13 +1,21 @@
 #include "Method.h"
+#include "ParseNode.h"
+#include "Environment.h"
 #include "ByteArray.h"
 #include "Array.h"
 #include "String.h"
 #include "Memory.h"
 #include "ByteCode.h"
 #include "Class.h"
+#include "Module.h"
+#include "Region.h"
 #include <stdio.h>
 
 struct Class Method_class;
+static Array* stubs = NULL;
+static int num_stubs = 0;
+static bool script_is_compiled = false;
+static int compile_depth = 0;
 
 void Method_init_class()
 {
@@ -26,4 +34,77 @@ Method* new_Method(int num_args)
 }
 
 
+Method* new_stub_Method(struct FunctionStatement* function, struct Environment* environment)
+{
+	Method* self = alloc_obj(Method);
+	self->class_ = &Method_class;
+	self->num_args = function->arguments->size;
+	self->function = function;
+	self->environment = environment;
+	if (stubs == NULL)
+		stubs = new_Array();
+	Array_append(stubs, (Object*) self);
+	num_stubs += 1;
+	return self;
+}
+
+
+void Method_compile_stub(Method* self)
+{
+	FunctionStatement* function = self->function;
+	Environment* environment = self->environment;
+
+	// Let go of the parse tree once we're compiled.
+	self->function = NULL;
+	self->environment = NULL;
+	num_stubs -= 1;
+
+	self->bytecode = new_ByteArray();
+	self->literals = new_Array();
+	compile_depth += 1;
+	FunctionStatement_compile_into(function, environment, self);
+	compile_depth -= 1;
+
+	// Compiling can build and run modules, which can compile more stubs; only
+	// the outermost compile is really done with the compiler's memory.
+	if (script_is_compiled && compile_depth == 0)
+		Method_release_compiler_data();
+}
+
+
+void Method_compile_all_stubs()
+{
+	if (stubs == NULL)
+		return;
+	// Compiling can make more stubs, which get appended as we go.
+	for (int i = 0; i < stubs->size; ++i) {
+		Method* method = (Method*) stubs->items[i];
+		if (Method_is_stub(method))
+			Method_compile_stub(method);
+		}
+	stubs = NULL;
+}
+
+
+int Method_num_stubs()
+{
+	return num_stubs;
+}
+
+
+void Method_finish_compiling()
+{
+	script_is_compiled = true;
+	Method_release_compiler_data();
+}
+
+
+void Method_release_compiler_data()
+{
+	// Whatever the compiler built that's still needed is reachable from the
+	// stubs, so the collector can take the rest, and take more as the stubs get
+	// compiled.
+	Module_release_parse_trees();
+	Region_let_go(&compiler_region);
+}
 
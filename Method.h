@@ -3,6 +3,8 @@
 struct ByteArray;
 struct Array;
 struct Class;
+struct FunctionStatement;
+struct Environment;
 
 
 typedef struct Method {
@@ -11,10 +13,25 @@ typedef struct Method {
 	struct ByteArray* bytecode;
 	struct Array* literals;
 	int stack_size;
+
+	// Functions are compiled lazily.  Until then, the Method is a "stub" with no
+	// bytecode, and these hold what's needed to compile it.
+	struct FunctionStatement* function;
+	struct Environment* environment;
 	} Method;
 
 Method* new_Method(int num_args);
+Method* new_stub_Method(struct FunctionStatement* function, struct Environment* environment);
+extern void Method_compile_stub(Method* self);
+extern void Method_compile_all_stubs();
+extern int Method_num_stubs();
+	// How many Methods haven't been compiled yet.
+extern void Method_finish_compiling();
+	// Call once the script is compiled.  From then on, the compiler's memory is
+	// let go of after each stub is compiled.
+extern void Method_release_compiler_data();
+
+#define Method_is_stub(method) ((method)->bytecode == NULL)
 
 extern struct Class Method_class;
 extern void Method_init_class();
-
@@ -8,15 +8,22 @@
 #include "Int.h"
 #include "ByteArray.h"
 #include "ByteCode.h"
+#include "Region.h"
 #include "Memory.h"
 #include "Error.h"
 
 
 MethodBuilder* new_MethodBuilder(Array* arguments, Environment* environment)
 {
-	MethodBuilder* self = alloc_obj(MethodBuilder);
+	return new_MethodBuilder_for_method(new_Method(arguments->size), arguments, environment);
+}
+
+
+MethodBuilder* new_MethodBuilder_for_method(Method* method, Array* arguments, Environment* environment)
+{
+	MethodBuilder* self = alloc_compiler_obj(MethodBuilder);
 	int num_args = arguments->size;
-	self->method = new_Method(num_args);
+	self->method = method;
 	self->arguments = arguments;
 	self->cur_num_variables = self->max_num_variables = num_args + 1;
 		// "self" and the arguments count as a variables here.
@@ -264,7 +271,7 @@ typedef struct LoopPoints {
 
 void MethodBuilder_push_loop_points(MethodBuilder* self)
 {
-	LoopPoints* loop_points = alloc_obj(LoopPoints);
+	LoopPoints* loop_points = alloc_compiler_obj(LoopPoints);
 	loop_points->parent = self->loop_points;
 	loop_points->continue_patch_points = new_Array();
 	loop_points->break_patch_points = new_Array();
@@ -23,6 +23,8 @@ typedef struct MethodBuilder {
 	} MethodBuilder;
 
 extern MethodBuilder* new_MethodBuilder(struct Array* arguments, struct Environment* environment);
+extern MethodBuilder* new_MethodBuilder_for_method(struct Method* method, struct Array* arguments, struct Environment* environment);
+	// Builds into an existing (empty) Method, such as a stub.
 extern void MethodBuilder_finish(MethodBuilder* self);
 extern void MethodBuilder_finish_init(MethodBuilder* self);
 
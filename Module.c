@@ -10,9 +10,11 @@
 #include "Dict.h"
 #include "Array.h"
 #include "Object.h"
+#include "Region.h"
 #include "Memory.h"
 #include "ByteCode.h"
 #include "File.h"
+#include "ByteCodeCache.h"
 #include "Error.h"
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -21,8 +23,11 @@
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
+#include <pthread.h>
 
 static Dict* modules = NULL;
+static Array* built_modules = NULL;
+static pthread_mutex_t loader_lock = PTHREAD_MUTEX_INITIALIZER;
 
 
 ParseNode* Parser_parse_export(Parser* self)
@@ -35,12 +40,12 @@ ParseNode* Parser_parse_export(Parser* self)
 		Error("\"export\" statement is not part of a module %s.", where(next_token.line_number, self->filename));
 
 	if (next_token.type == Identifier) {
-		if (String_equals_c(next_token.token, "class")) {
+		if (next_token.kind == K_CLASS) {
 			ClassStatement* class_statement = (ClassStatement*) Parser_parse_class_statement(self);
 			Dict_set_at(module->exported_classes, ClassStatement_get_name(class_statement), (Object*) class_statement);
 			return (ParseNode*) class_statement;
 			}
-		else if (String_equals_c(next_token.token, "fn")) {
+		else if (next_token.kind == K_FN) {
 			FunctionStatement* fn_statement = (FunctionStatement*) Parser_parse_fn_statement(self);
 			Dict_set_at(module->exported_functions, fn_statement->name, (Object*) fn_statement);
 			return (ParseNode*) fn_statement;
@@ -75,7 +80,7 @@ int ImportStatement_emit(ParseNode* super, MethodBuilder* builder)
 
 ImportStatement* new_ImportStatement()
 {
-	ImportStatement* self = alloc_obj(ImportStatement);
+	ImportStatement* self = alloc_compiler_obj(ImportStatement);
 	self->parse_node.emit = ImportStatement_emit;
 	self->imported_modules = new_Array();
 	return self;
@@ -92,7 +97,7 @@ ParseNode* Parser_parse_import(Parser* self)
 		Token token = Lexer_next(self->lexer);
 		if (token.type == EOL)
 			break;
-		if (token.type == Operator && String_equals_c(token.token, ","))
+		if (token.type == Operator && token.kind == K_COMMA)
 			continue;
 		if (token.type != Identifier)
 			Error("Expected a module name in \"import\" statement %s.", where(token.line_number, self->filename));
@@ -141,24 +146,46 @@ const char* follow_link(const char* path)
 }
 
 
-Module* Module_load_from_file(String* name, const char* file_path);
+static const char* find_module_file(const char* path)
+{
+	// Returns the path of the module's file, trying it with a ".sqs" extension
+	// if needed, or NULL if there's no such file.
+	struct stat stat_buf;
+	if (stat(path, &stat_buf) == 0 && S_ISREG(stat_buf.st_mode))
+		return path;
+	declare_static_string(extension_string, ".sqs");
+	const char* sqs_path = String_c_str(String_add(new_c_String(path), &extension_string));
+	if (stat(sqs_path, &stat_buf) == 0 && S_ISREG(stat_buf.st_mode))
+		return sqs_path;
+	return NULL;
+}
+
+
+static void Module_run(Module* module);
+static void Module_start_loading(Module* module, const char* file_path);
 
 Module* Module_get_module(String* name)
 {
-	// Did we already load it?
+	// This can be called from the loader threads as well as the main one.
+	pthread_mutex_lock(&loader_lock);
+
+	// Did we already load it (or start to)?
 	if (modules == NULL)
 		modules = new_Dict();
 	Module* module = (Module*) Dict_at(modules, name);
-	if (module)
+	if (module) {
+		pthread_mutex_unlock(&loader_lock);
 		return module;
+		}
 
-	// Load it.
 	// Get the path to the original script.
 	declare_static_string(argv_string, "argv");
 	GlobalExpr* argv_expr =
 		(GlobalExpr*) global_environment.environment.find(&global_environment.environment, &argv_string);
-	if (argv_expr == NULL)
+	if (argv_expr == NULL) {
+		pthread_mutex_unlock(&loader_lock);
 		return NULL;
+		}
 	Array* argv = (Array*) argv_expr->object;
 	const char* argv_0 = String_c_str((String*) Array_at(argv, 0));
 	const char* followed_argv_0 = follow_link(argv_0);
@@ -177,36 +204,143 @@ Module* Module_get_module(String* name)
 		path = String_c_str(Array_join(path_array, NULL));
 		}
 
-	// Load it.
-	module = Module_load_from_file(name, path);
+	// Make sure the file is there now, so a bad import gets reported where it
+	// is, instead of from a loader thread.
+	const char* file_path = find_module_file(path);
+	if (file_path == NULL) {
+		pthread_mutex_unlock(&loader_lock);
+		return NULL;
+		}
+
+	// Get the module into "modules" before parsing it, in case there is mutual
+	// recursion.  The parsing itself happens on the loader threads; the parser
+	// doesn't need anything from the module besides the Module itself.
+	module = new_Module();
+	module->name = name;
+	if (file_path != path)
+		module->missing_path = new_c_String(path);
+	Dict_set_at(modules, name, (Object*) module);
+	Module_start_loading(module, file_path);
+
+	pthread_mutex_unlock(&loader_lock);
 	return module;
 }
 
 
-Module* Module_load_from_file(String* name, const char* file_path)
+static void Module_parse(Module* module, const char* file_path)
 {
 	// Read the file.
 	String* contents = file_contents(file_path);
-	if (contents == NULL) {
-		// Try it with a ".sqs" extension.
-		declare_static_string(extension_string, ".sqs");
-		String* new_path = String_add(make_string(file_path), &extension_string);
-		contents = file_contents(String_c_str(new_path));
-		}
 	if (contents == NULL)
 		Error("Couldn't open \"%s\" (%s).", file_path, strerror(errno));
+	module->path = new_c_String(file_path);
+	module->source_hash = ByteCodeCache_source_hash(contents);
 
-	// Get the module into "modules" before parsing it, in case there is mutual
-	// recursion.
-	Module* module = new_Module();
-	Dict_set_at(modules, name, (Object*) module);
+	Parser* parser = new_Parser(contents->str, contents->size, module->name);
+	module->block = (Block*) Parser_parse_block(parser, module);
+}
 
-	Parser* parser = new_Parser(contents->str, contents->size, name);
-	ParseNode* ast = Parser_parse_block(parser, module);
-	if (ast == NULL)
-		return NULL;
-	module->block = (Block*) ast;
-	return module;
+
+// Modules are parsed by a small pool of threads.  Threads are started as work
+// shows up (up to max_loader_threads), and quit when there's nothing left to
+// do.  Each one allocates from its own compiler_region, and hands it over
+// when it quits.
+// All of these are protected by "loader_lock".
+
+typedef struct LoadRequest {
+	struct LoadRequest* next;
+	Module* module;
+	const char* file_path;
+	} LoadRequest;
+
+static const int max_loader_threads = 8;
+static LoadRequest* load_requests = NULL;
+static LoadRequest** load_requests_tail = &load_requests;
+static int num_pending_loads = 0;
+static int num_loader_threads = 0;
+static Array* loader_regions = NULL;
+static pthread_cond_t loader_done = PTHREAD_COND_INITIALIZER;
+
+static LoadRequest* next_load_request()
+{
+	LoadRequest* request = load_requests;
+	if (request) {
+		load_requests = request->next;
+		if (load_requests == NULL)
+			load_requests_tail = &load_requests;
+		}
+	return request;
+}
+
+static void run_load_requests()
+{
+	// Call with "loader_lock" locked.
+	while (true) {
+		LoadRequest* request = next_load_request();
+		if (request == NULL)
+			break;
+		pthread_mutex_unlock(&loader_lock);
+		Module_parse(request->module, request->file_path);
+		pthread_mutex_lock(&loader_lock);
+		num_pending_loads -= 1;
+		}
+}
+
+static void* loader_thread(void* arg)
+{
+	pthread_mutex_lock(&loader_lock);
+	run_load_requests();
+
+	// Hand over our parse trees.
+	Region* region = alloc_obj(Region);
+	Region_adopt(region, &compiler_region);
+	if (loader_regions == NULL)
+		loader_regions = new_Array();
+	Array_append(loader_regions, (Object*) region);
+
+	num_loader_threads -= 1;
+	pthread_cond_broadcast(&loader_done);
+	pthread_mutex_unlock(&loader_lock);
+	return NULL;
+}
+
+static void Module_start_loading(Module* module, const char* file_path)
+{
+	// Call with "loader_lock" locked.
+	LoadRequest* request = alloc_obj(LoadRequest);
+	request->module = module;
+	request->file_path = file_path;
+	*load_requests_tail = request;
+	load_requests_tail = &request->next;
+	num_pending_loads += 1;
+
+	// Start another thread if we can.  If we can't, Module_finish_loading()
+	// will do the work itself.
+	if (num_loader_threads < max_loader_threads) {
+		pthread_attr_t attributes;
+		pthread_attr_init(&attributes);
+		pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+		pthread_t thread;
+		if (pthread_create(&thread, &attributes, loader_thread, NULL) == 0)
+			num_loader_threads += 1;
+		pthread_attr_destroy(&attributes);
+		}
+}
+
+void Module_finish_loading()
+{
+	pthread_mutex_lock(&loader_lock);
+	run_load_requests();
+	while (num_pending_loads > 0 || num_loader_threads > 0)
+		pthread_cond_wait(&loader_done, &loader_lock);
+
+	// Take over the threads' parse trees, so they get released along with ours.
+	if (loader_regions) {
+		for (int i = 0; i < loader_regions->size; ++i)
+			Region_adopt(&compiler_region, (Region*) loader_regions->items[i]);
+		loader_regions = NULL;
+		}
+	pthread_mutex_unlock(&loader_lock);
 }
 
 
@@ -224,6 +358,7 @@ struct ClassStatement* Module_exported_class(Module* self, String* name)
 void Module_create_module_locals(Module* self, int num_locals)
 {
 	self->locals = (Object**) alloc_mem(num_locals * sizeof(Object*));
+	self->num_locals = num_locals;
 }
 
 
@@ -235,14 +370,75 @@ void Module_build(Module* module)
 
 	MethodBuilder* method_builder = new_MethodBuilder(new_Array(), NULL);
 	MethodBuilder_add_literal(method_builder, (Object*) new_c_static_String("-module-"));
-	module->block->parse_node.emit(&module->block->parse_node, method_builder);
+	if (module->block) 	// It's NULL if the module is empty.
+		module->block->parse_node.emit(&module->block->parse_node, method_builder);
 	MethodBuilder_finish(method_builder);
 	module->method = method_builder->method;
-	call_method(module->method, NULL);
+	Module_run(module);
 	module->is_building = false;
 }
 
 
+static void Module_run(Module* module)
+{
+	if (built_modules == NULL)
+		built_modules = new_Array();
+	Array_append(built_modules, (Object*) module);
+	call_method(module->method, NULL);
+}
+
+
+Array* Module_get_built_modules()
+{
+	if (built_modules == NULL)
+		built_modules = new_Array();
+	return built_modules;
+}
+
+
+Module* new_prebuilt_Module(String* name, String* path, int num_locals)
+{
+	Module* module = new_Module();
+	module->name = name;
+	module->path = path;
+	Module_create_module_locals(module, num_locals);
+	return module;
+}
+
+
+void Module_run_prebuilt(Module* module)
+{
+	if (modules == NULL)
+		modules = new_Dict();
+	Dict_set_at(modules, module->name, (Object*) module);
+	Module_run(module);
+}
+
+
+void Module_release_parse_trees()
+{
+	// Drop the references into the compiler's memory that aren't needed any
+	// more.  A module's block is needed until it's built, and its exports as long
+	// as there's anything left to compile that might use them.
+	if (modules == NULL)
+		return;
+	bool done_compiling = (Method_num_stubs() == 0);
+	DictIterator* it = new_DictIterator(modules);
+	while (true) {
+		DictIteratorResult kv = DictIterator_next(it);
+		if (kv.key == NULL)
+			break;
+		Module* module = (Module*) kv.value;
+		if (module->method || done_compiling)
+			module->block = NULL;
+		if (done_compiling) {
+			module->exported_classes = NULL;
+			module->exported_functions = NULL;
+			}
+		}
+}
+
+
 int ModuleLocal_emit(ParseNode* super, MethodBuilder* builder)
 {
 	Local* self = (Local*) super;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 
 struct Parser;
 struct ParseNode;
@@ -8,24 +9,44 @@ struct BlockContext;
 struct BlockUpvalueContext;
 struct String;
 struct Dict;
+struct Array;
 
 
 extern struct ParseNode* Parser_parse_export(struct Parser* self);
 extern struct ParseNode* Parser_parse_import(struct Parser* self);
 
 typedef struct Module {
+	struct String* name;
+	struct String* path;
+	uint64_t source_hash; 	// So the cache can tell if it changed after parsing.
+	struct String* missing_path;
+		// Where the module was looked for first, but not found.  If a file shows
+		// up there, it'll be loaded instead.
 	struct Block* block;
 	struct Method* method;
 	struct Dict* exported_classes;
 	struct Dict* exported_functions;
 	struct Object** locals;
+	int num_locals;
 	bool is_building;
 	} Module;
 extern Module* Module_get_module(struct String* name);
 extern struct FunctionStatement* Module_exported_function(Module* self, struct String* name);
 extern struct ClassStatement* Module_exported_class(Module* self, struct String* name);
 extern void Module_create_module_locals(Module* self, int num_locals);
+extern void Module_finish_loading();
+	// Modules are parsed on other threads; this waits for them all to finish.
+	// Call it before emitting anything.
 extern void Module_build(Module* module);
+extern struct Array* Module_get_built_modules();
+	// In the order they were run.
+
+// For modules loaded from the bytecode cache, which never get parsed.
+extern Module* new_prebuilt_Module(struct String* name, struct String* path, int num_locals);
+extern void Module_run_prebuilt(Module* module);
+
+extern void Module_release_parse_trees();
+	// Call this once the script is compiled, and again as stubs get compiled.
 
 extern void BlockContext_make_module_context(struct BlockContext* context);
 extern void BlockUpvalueContext_make_module_context(struct BlockUpvalueContext* context);
@@ -13,13 +13,9 @@ Object* Nil_string(Object* self, Object** args)
 
 void Nil_init_class()
 {
-	Class_init_static(&Nil_class, "Nil", 0);
+	init_static_class_ivars(Nil, 0);
 
-	static BuiltinMethodSpec builtin_methods[] = {
-		{ "string", 0, Nil_string },
-		{ NULL },
-		};
-	Class_add_builtin_methods(&Nil_class, builtin_methods);
+	set_builtin_methods(Nil);
 }
 
 
@@ -0,0 +1,710 @@
+#include "NumberArray.h"
+#include "Array.h"
+#include "String.h"
+#include "Int.h"
+#include "Float.h"
+#include "Boolean.h"
+#include "ByteCode.h"
+#include "Memory.h"
+#include "Error.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#define min_capacity 16
+
+Class IntArray_class;
+Class FloatArray_class;
+
+typedef enum { Add, Subtract, Multiply, Divide } ElementwiseOp;
+
+declare_static_string(string_string, "string");
+declare_static_string(as_array_string, "as-array");
+
+
+static void* allocate_numbers(size_t capacity, size_t item_size)
+{
+	if (capacity == 0)
+		return NULL;
+	void* array = alloc_mem_no_pointers(capacity * item_size);
+	memset(array, 0, capacity * item_size);
+	return array;
+}
+
+static void* grow_numbers(void* array, size_t size, size_t* capacity, size_t needed_size, size_t item_size)
+{
+	// Anything past the size is always zero, so growing by setting past the end
+	// leaves zeros in between.
+	if (needed_size <= *capacity)
+		return array;
+	size_t new_capacity = (*capacity < min_capacity ? min_capacity : *capacity * 2);
+	while (new_capacity < needed_size)
+		new_capacity *= 2;
+	void* new_array = allocate_numbers(new_capacity, item_size);
+	if (size > 0)
+		memcpy(new_array, array, size * item_size);
+	*capacity = new_capacity;
+	return new_array;
+}
+
+static size_t checked_index(Object* index_obj, size_t size, const char* name)
+{
+	int index = Int_enforce(index_obj, name);
+	if (index < 0)
+		index += size;
+	if (index < 0)
+		Error("Negative index out of bounds in \"%s\".", name);
+	return index;
+}
+
+
+// Loops over contiguous memory.  These are kept simple, so the compiler can
+// vectorize them.
+
+static int64_t int_sum(const int* values, size_t size)
+{
+	int64_t sum = 0;
+	for (size_t i = 0; i < size; ++i)
+		sum += values[i];
+	return sum;
+}
+
+static int int_min(const int* values, size_t size)
+{
+	int result = values[0];
+	for (size_t i = 1; i < size; ++i)
+		result = (values[i] < result ? values[i] : result);
+	return result;
+}
+
+static int int_max(const int* values, size_t size)
+{
+	int result = values[0];
+	for (size_t i = 1; i < size; ++i)
+		result = (values[i] > result ? values[i] : result);
+	return result;
+}
+
+static double float_sum(const double* values, size_t size)
+{
+	// Floating-point addition isn't associative, so the compiler won't reorder
+	// a single running sum.  Four independent sums let it use vector adds.
+	double sums[4] = { 0.0, 0.0, 0.0, 0.0 };
+	size_t i = 0;
+	for (; i + 4 <= size; i += 4) {
+		sums[0] += values[i];
+		sums[1] += values[i + 1];
+		sums[2] += values[i + 2];
+		sums[3] += values[i + 3];
+		}
+	double sum = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+	for (; i < size; ++i)
+		sum += values[i];
+	return sum;
+}
+
+static double float_min(const double* values, size_t size)
+{
+	double result = values[0];
+	for (size_t i = 1; i < size; ++i)
+		result = (values[i] < result ? values[i] : result);
+	return result;
+}
+
+static double float_max(const double* values, size_t size)
+{
+	double result = values[0];
+	for (size_t i = 1; i < size; ++i)
+		result = (values[i] > result ? values[i] : result);
+	return result;
+}
+
+static void int_elementwise(int* result, const int* a, const int* b, int scalar, size_t size, ElementwiseOp op)
+{
+	// "b" is NULL to use "scalar" instead.
+	if (op == Divide) {
+		if (b == NULL && scalar == 0)
+			Error("Division by zero in IntArray./.");
+		for (size_t i = 0; b && i < size; ++i) {
+			if (b[i] == 0)
+				Error("Division by zero in IntArray./.");
+			}
+		}
+	switch (op) {
+		case Add:
+			if (b) { for (size_t i = 0; i < size; ++i) result[i] = a[i] + b[i]; }
+			else { for (size_t i = 0; i < size; ++i) result[i] = a[i] + scalar; }
+			break;
+		case Subtract:
+			if (b) { for (size_t i = 0; i < size; ++i) result[i] = a[i] - b[i]; }
+			else { for (size_t i = 0; i < size; ++i) result[i] = a[i] - scalar; }
+			break;
+		case Multiply:
+			if (b) { for (size_t i = 0; i < size; ++i) result[i] = a[i] * b[i]; }
+			else { for (size_t i = 0; i < size; ++i) result[i] = a[i] * scalar; }
+			break;
+		case Divide:
+			if (b) { for (size_t i = 0; i < size; ++i) result[i] = a[i] / b[i]; }
+			else { for (size_t i = 0; i < size; ++i) result[i] = a[i] / scalar; }
+			break;
+		}
+}
+
+static void float_elementwise(double* result, const double* a, const double* b, double scalar, size_t size, ElementwiseOp op)
+{
+	// "b" is NULL to use "scalar" instead.
+	switch (op) {
+		case Add:
+			if (b) { for (size_t i = 0; i < size; ++i) result[i] = a[i] + b[i]; }
+			else { for (size_t i = 0; i < size; ++i) result[i] = a[i] + scalar; }
+			break;
+		case Subtract:
+			if (b) { for (size_t i = 0; i < size; ++i) result[i] = a[i] - b[i]; }
+			else { for (size_t i = 0; i < size; ++i) result[i] = a[i] - scalar; }
+			break;
+		case Multiply:
+			if (b) { for (size_t i = 0; i < size; ++i) result[i] = a[i] * b[i]; }
+			else { for (size_t i = 0; i < size; ++i) result[i] = a[i] * scalar; }
+			break;
+		case Divide:
+			if (b) { for (size_t i = 0; i < size; ++i) result[i] = a[i] / b[i]; }
+			else { for (size_t i = 0; i < size; ++i) result[i] = a[i] / scalar; }
+			break;
+		}
+}
+
+static int histogram_bucket(double value, double lo, double hi, int num_buckets)
+{
+	// Returns -1 if the value is out of range (or NaN).
+	if (!(value >= lo && value <= hi))
+		return -1;
+	if (hi == lo)
+		return 0;
+	int bucket = (int) ((value - lo) / (hi - lo) * num_buckets);
+	return (bucket >= num_buckets ? num_buckets - 1 : bucket);
+}
+
+static int compare_ints(const void* a, const void* b)
+{
+	int a_value = *(const int*) a;
+	int b_value = *(const int*) b;
+	return (a_value > b_value) - (a_value < b_value);
+}
+
+static int compare_doubles(const void* a, const void* b)
+{
+	double a_value = *(const double*) a;
+	double b_value = *(const double*) b;
+	return (a_value > b_value) - (a_value < b_value);
+}
+
+
+IntArray* new_IntArray(size_t size)
+{
+	IntArray* self = alloc_obj(IntArray);
+	self->class_ = &IntArray_class;
+	self->size = self->capacity = size;
+	self->array = (int*) allocate_numbers(size, sizeof(int));
+	return self;
+}
+
+static void IntArray_set_at(IntArray* self, size_t index, int value)
+{
+	if (index >= self->size) {
+		self->array = (int*) grow_numbers(self->array, self->size, &self->capacity, index + 1, sizeof(int));
+		self->size = index + 1;
+		}
+	self->array[index] = value;
+}
+
+void IntArray_append(IntArray* self, int value)
+{
+	IntArray_set_at(self, self->size, value);
+}
+
+static void IntArray_append_items(IntArray* self, Object* items)
+{
+	if (items->class_ == &IntArray_class) {
+		IntArray* other = (IntArray*) items;
+		size_t old_size = self->size;
+		self->array = (int*) grow_numbers(self->array, self->size, &self->capacity, old_size + other->size, sizeof(int));
+		if (other->size > 0)
+			memcpy(self->array + old_size, other->array, other->size * sizeof(int));
+		self->size += other->size;
+		}
+	else if (items->class_ == &Array_class) {
+		Array* other = (Array*) items;
+		self->array = (int*) grow_numbers(self->array, self->size, &self->capacity, self->size + other->size, sizeof(int));
+		for (size_t i = 0; i < other->size; ++i)
+			IntArray_append(self, Int_enforce(Array_at(other, i), "IntArray.init"));
+		}
+	else {
+		Object* it = call_object(items, &iterator_string, NULL);
+		while (true) {
+			Object* item = call_object(it, &next_string, NULL);
+			if (item == NULL)
+				break;
+			IntArray_append(self, Int_enforce(item, "IntArray.init"));
+			}
+		}
+}
+
+static FloatArray* IntArray_as_float_array(IntArray* self)
+{
+	FloatArray* result = new_FloatArray(self->size);
+	for (size_t i = 0; i < self->size; ++i)
+		result->array[i] = self->array[i];
+	return result;
+}
+
+
+FloatArray* new_FloatArray(size_t size)
+{
+	FloatArray* self = alloc_obj(FloatArray);
+	self->class_ = &FloatArray_class;
+	self->size = self->capacity = size;
+	self->array = (double*) allocate_numbers(size, sizeof(double));
+	return self;
+}
+
+static void FloatArray_set_at(FloatArray* self, size_t index, double value)
+{
+	if (index >= self->size) {
+		self->array = (double*) grow_numbers(self->array, self->size, &self->capacity, index + 1, sizeof(double));
+		self->size = index + 1;
+		}
+	self->array[index] = value;
+}
+
+void FloatArray_append(FloatArray* self, double value)
+{
+	FloatArray_set_at(self, self->size, value);
+}
+
+static void FloatArray_append_items(FloatArray* self, Object* items)
+{
+	if (items->class_ == &FloatArray_class) {
+		FloatArray* other = (FloatArray*) items;
+		size_t old_size = self->size;
+		self->array = (double*) grow_numbers(self->array, self->size, &self->capacity, old_size + other->size, sizeof(double));
+		if (other->size > 0)
+			memcpy(self->array + old_size, other->array, other->size * sizeof(double));
+		self->size += other->size;
+		}
+	else if (items->class_ == &IntArray_class) {
+		IntArray* other = (IntArray*) items;
+		self->array = (double*) grow_numbers(self->array, self->size, &self->capacity, self->size + other->size, sizeof(double));
+		for (size_t i = 0; i < other->size; ++i)
+			FloatArray_append(self, other->array[i]);
+		}
+	else if (items->class_ == &Array_class) {
+		Array* other = (Array*) items;
+		self->array = (double*) grow_numbers(self->array, self->size, &self->capacity, self->size + other->size, sizeof(double));
+		for (size_t i = 0; i < other->size; ++i)
+			FloatArray_append(self, Float_enforce(Array_at(other, i), "FloatArray.init"));
+		}
+	else {
+		Object* it = call_object(items, &iterator_string, NULL);
+		while (true) {
+			Object* item = call_object(it, &next_string, NULL);
+			if (item == NULL)
+				break;
+			FloatArray_append(self, Float_enforce(item, "FloatArray.init"));
+			}
+		}
+}
+
+
+static Object* FloatArray_elementwise(FloatArray* self, Object* other, ElementwiseOp op, const char* name)
+{
+	FloatArray* result = new_FloatArray(self->size);
+	if (other && (other->class_ == &Float_class || other->class_ == &Int_class))
+		float_elementwise(result->array, self->array, NULL, Float_enforce(other, name), self->size, op);
+	else if (other && (other->class_ == &FloatArray_class || other->class_ == &IntArray_class)) {
+		FloatArray* other_floats = (FloatArray*) other;
+		if (other->class_ == &IntArray_class)
+			other_floats = IntArray_as_float_array((IntArray*) other);
+		if (other_floats->size != self->size)
+			Error("Size mismatch in \"%s\" (%d vs. %d).", name, (int) self->size, (int) other_floats->size);
+		float_elementwise(result->array, self->array, other_floats->array, 0.0, self->size, op);
+		}
+	else
+		Error("\"%s\" needs a number, IntArray, or FloatArray.", name);
+	return (Object*) result;
+}
+
+static Object* IntArray_elementwise(IntArray* self, Object* other, ElementwiseOp op, const char* name)
+{
+	// The result is an IntArray only if both sides are Ints.
+	if (other && other->class_ == &Int_class) {
+		IntArray* result = new_IntArray(self->size);
+		int_elementwise(result->array, self->array, NULL, Int_value(other), self->size, op);
+		return (Object*) result;
+		}
+	else if (other && other->class_ == &IntArray_class) {
+		IntArray* other_ints = (IntArray*) other;
+		if (other_ints->size != self->size)
+			Error("Size mismatch in \"%s\" (%d vs. %d).", name, (int) self->size, (int) other_ints->size);
+		IntArray* result = new_IntArray(self->size);
+		int_elementwise(result->array, self->array, other_ints->array, 0, self->size, op);
+		return (Object*) result;
+		}
+	return FloatArray_elementwise(IntArray_as_float_array(self), other, op, name);
+}
+
+
+Object* IntArray_init_builtin(Object* super, Object** args)
+{
+	IntArray* self = (IntArray*) super;
+	self->class_ = &IntArray_class;
+	self->size = self->capacity = 0;
+	self->array = NULL;
+
+	Object* initial = args[0];
+	if (initial && initial->class_ == &Int_class) {
+		int size = Int_value(initial);
+		if (size < 0)
+			Error("Negative size given to IntArray.init.");
+		self->size = self->capacity = size;
+		self->array = (int*) allocate_numbers(size, sizeof(int));
+		}
+	else if (initial)
+		IntArray_append_items(self, initial);
+
+	return super;
+}
+
+Object* IntArray_size_builtin(Object* super, Object** args)
+{
+	return (Object*) new_Int(((IntArray*) super)->size);
+}
+
+Object* IntArray_is_empty_builtin(Object* super, Object** args)
+{
+	return make_bool(((IntArray*) super)->size == 0);
+}
+
+Object* IntArray_at_builtin(Object* super, Object** args)
+{
+	IntArray* self = (IntArray*) super;
+	size_t index = checked_index(args[0], self->size, "IntArray.[]");
+	if (index >= self->size)
+		Error("IntArray index out of bounds.");
+	return (Object*) new_Int(self->array[index]);
+}
+
+Object* IntArray_set_at_builtin(Object* super, Object** args)
+{
+	IntArray* self = (IntArray*) super;
+	size_t index = checked_index(args[0], self->size, "IntArray.[]=");
+	IntArray_set_at(self, index, Int_enforce(args[1], "IntArray.[]= value"));
+	return args[1];
+}
+
+Object* IntArray_append_builtin(Object* super, Object** args)
+{
+	IntArray_append((IntArray*) super, Int_enforce(args[0], "IntArray.append"));
+	return super;
+}
+
+Object* IntArray_extend_builtin(Object* super, Object** args)
+{
+	if (args[0])
+		IntArray_append_items((IntArray*) super, args[0]);
+	return super;
+}
+
+Object* IntArray_sum_builtin(Object* super, Object** args)
+{
+	IntArray* self = (IntArray*) super;
+	int64_t sum = int_sum(self->array, self->size);
+	if (sum < INT_MIN || sum > INT_MAX)
+		return (Object*) new_Float(sum);
+	return (Object*) new_Int(sum);
+}
+
+Object* IntArray_min_builtin(Object* super, Object** args)
+{
+	IntArray* self = (IntArray*) super;
+	if (self->size == 0)
+		return NULL;
+	return (Object*) new_Int(int_min(self->array, self->size));
+}
+
+Object* IntArray_max_builtin(Object* super, Object** args)
+{
+	IntArray* self = (IntArray*) super;
+	if (self->size == 0)
+		return NULL;
+	return (Object*) new_Int(int_max(self->array, self->size));
+}
+
+Object* IntArray_mean_builtin(Object* super, Object** args)
+{
+	IntArray* self = (IntArray*) super;
+	if (self->size == 0)
+		return NULL;
+	return (Object*) new_Float((double) int_sum(self->array, self->size) / self->size);
+}
+
+Object* IntArray_sort_builtin(Object* super, Object** args)
+{
+	IntArray* self = (IntArray*) super;
+	qsort(self->array, self->size, sizeof(int), compare_ints);
+	return super;
+}
+
+Object* IntArray_histogram_builtin(Object* super, Object** args)
+{
+	IntArray* self = (IntArray*) super;
+	int num_buckets = Int_enforce(args[0], "IntArray.histogram");
+	if (num_buckets <= 0)
+		Error("IntArray.histogram needs at least one bucket.");
+	IntArray* counts = new_IntArray(num_buckets);
+	if (self->size == 0)
+		return (Object*) counts;
+	double lo = (args[1] ? Float_enforce(args[1], "IntArray.histogram") : int_min(self->array, self->size));
+	double hi = (args[2] ? Float_enforce(args[2], "IntArray.histogram") : int_max(self->array, self->size));
+	for (size_t i = 0; i < self->size; ++i) {
+		int bucket = histogram_bucket(self->array[i], lo, hi, num_buckets);
+		if (bucket >= 0)
+			counts->array[bucket] += 1;
+		}
+	return (Object*) counts;
+}
+
+Object* IntArray_add_builtin(Object* super, Object** args)
+{
+	return IntArray_elementwise((IntArray*) super, args[0], Add, "IntArray.+");
+}
+
+Object* IntArray_subtract_builtin(Object* super, Object** args)
+{
+	return IntArray_elementwise((IntArray*) super, args[0], Subtract, "IntArray.-");
+}
+
+Object* IntArray_multiply_builtin(Object* super, Object** args)
+{
+	return IntArray_elementwise((IntArray*) super, args[0], Multiply, "IntArray.*");
+}
+
+Object* IntArray_divide_builtin(Object* super, Object** args)
+{
+	return IntArray_elementwise((IntArray*) super, args[0], Divide, "IntArray./");
+}
+
+Object* IntArray_as_array_builtin(Object* super, Object** args)
+{
+	IntArray* self = (IntArray*) super;
+	Array* result = new_Array();
+	Array_reserve(result, self->size);
+	for (size_t i = 0; i < self->size; ++i)
+		Array_append(result, (Object*) new_Int(self->array[i]));
+	return (Object*) result;
+}
+
+Object* IntArray_as_float_array_builtin(Object* super, Object** args)
+{
+	return (Object*) IntArray_as_float_array((IntArray*) super);
+}
+
+
+Object* FloatArray_init_builtin(Object* super, Object** args)
+{
+	FloatArray* self = (FloatArray*) super;
+	self->class_ = &FloatArray_class;
+	self->size = self->capacity = 0;
+	self->array = NULL;
+
+	Object* initial = args[0];
+	if (initial && initial->class_ == &Int_class) {
+		int size = Int_value(initial);
+		if (size < 0)
+			Error("Negative size given to FloatArray.init.");
+		self->size = self->capacity = size;
+		self->array = (double*) allocate_numbers(size, sizeof(double));
+		}
+	else if (initial)
+		FloatArray_append_items(self, initial);
+
+	return super;
+}
+
+Object* FloatArray_size_builtin(Object* super, Object** args)
+{
+	return (Object*) new_Int(((FloatArray*) super)->size);
+}
+
+Object* FloatArray_is_empty_builtin(Object* super, Object** args)
+{
+	return make_bool(((FloatArray*) super)->size == 0);
+}
+
+Object* FloatArray_at_builtin(Object* super, Object** args)
+{
+	FloatArray* self = (FloatArray*) super;
+	size_t index = checked_index(args[0], self->size, "FloatArray.[]");
+	if (index >= self->size)
+		Error("FloatArray index out of bounds.");
+	return (Object*) new_Float(self->array[index]);
+}
+
+Object* FloatArray_set_at_builtin(Object* super, Object** args)
+{
+	FloatArray* self = (FloatArray*) super;
+	size_t index = checked_index(args[0], self->size, "FloatArray.[]=");
+	FloatArray_set_at(self, index, Float_enforce(args[1], "FloatArray.[]= value"));
+	return args[1];
+}
+
+Object* FloatArray_append_builtin(Object* super, Object** args)
+{
+	FloatArray_append((FloatArray*) super, Float_enforce(args[0], "FloatArray.append"));
+	return super;
+}
+
+Object* FloatArray_extend_builtin(Object* super, Object** args)
+{
+	if (args[0])
+		FloatArray_append_items((FloatArray*) super, args[0]);
+	return super;
+}
+
+Object* FloatArray_sum_builtin(Object* super, Object** args)
+{
+	FloatArray* self = (FloatArray*) super;
+	return (Object*) new_Float(float_sum(self->array, self->size));
+}
+
+Object* FloatArray_min_builtin(Object* super, Object** args)
+{
+	FloatArray* self = (FloatArray*) super;
+	if (self->size == 0)
+		return NULL;
+	return (Object*) new_Float(float_min(self->array, self->size));
+}
+
+Object* FloatArray_max_builtin(Object* super, Object** args)
+{
+	FloatArray* self = (FloatArray*) super;
+	if (self->size == 0)
+		return NULL;
+	return (Object*) new_Float(float_max(self->array, self->size));
+}
+
+Object* FloatArray_mean_builtin(Object* super, Object** args)
+{
+	FloatArray* self = (FloatArray*) super;
+	if (self->size == 0)
+		return NULL;
+	return (Object*) new_Float(float_sum(self->array, self->size) / self->size);
+}
+
+Object* FloatArray_sort_builtin(Object* super, Object** args)
+{
+	FloatArray* self = (FloatArray*) super;
+	qsort(self->array, self->size, sizeof(double), compare_doubles);
+	return super;
+}
+
+Object* FloatArray_histogram_builtin(Object* super, Object** args)
+{
+	FloatArray* self = (FloatArray*) super;
+	int num_buckets = Int_enforce(args[0], "FloatArray.histogram");
+	if (num_buckets <= 0)
+		Error("FloatArray.histogram needs at least one bucket.");
+	IntArray* counts = new_IntArray(num_buckets);
+	if (self->size == 0)
+		return (Object*) counts;
+	double lo = (args[1] ? Float_enforce(args[1], "FloatArray.histogram") : float_min(self->array, self->size));
+	double hi = (args[2] ? Float_enforce(args[2], "FloatArray.histogram") : float_max(self->array, self->size));
+	for (size_t i = 0; i < self->size; ++i) {
+		int bucket = histogram_bucket(self->array[i], lo, hi, num_buckets);
+		if (bucket >= 0)
+			counts->array[bucket] += 1;
+		}
+	return (Object*) counts;
+}
+
+Object* FloatArray_add_builtin(Object* super, Object** args)
+{
+	return FloatArray_elementwise((FloatArray*) super, args[0], Add, "FloatArray.+");
+}
+
+Object* FloatArray_subtract_builtin(Object* super, Object** args)
+{
+	return FloatArray_elementwise((FloatArray*) super, args[0], Subtract, "FloatArray.-");
+}
+
+Object* FloatArray_multiply_builtin(Object* super, Object** args)
+{
+	return FloatArray_elementwise((FloatArray*) super, args[0], Multiply, "FloatArray.*");
+}
+
+Object* FloatArray_divide_builtin(Object* super, Object** args)
+{
+	return FloatArray_elementwise((FloatArray*) super, args[0], Divide, "FloatArray./");
+}
+
+Object* FloatArray_as_array_builtin(Object* super, Object** args)
+{
+	FloatArray* self = (FloatArray*) super;
+	Array* result = new_Array();
+	Array_reserve(result, self->size);
+	for (size_t i = 0; i < self->size; ++i)
+		Array_append(result, (Object*) new_Float(self->array[i]));
+	return (Object*) result;
+}
+
+
+Object* NumberArray_string_builtin(Object* super, Object** args)
+{
+	Object* as_array = call_object(super, &as_array_string, NULL);
+	return call_object(as_array, &string_string, NULL);
+}
+
+
+typedef struct NumberArrayIterator {
+	Class* class_;
+	Object* number_array;
+	size_t index;
+	} NumberArrayIterator;
+Class NumberArrayIterator_class;
+
+Object* NumberArrayIterator_next(Object* super, Object** args)
+{
+	NumberArrayIterator* self = (NumberArrayIterator*) super;
+	if (self->number_array->class_ == &IntArray_class) {
+		IntArray* int_array = (IntArray*) self->number_array;
+		if (self->index >= int_array->size)
+			return NULL;
+		return (Object*) new_Int(int_array->array[self->index++]);
+		}
+	FloatArray* float_array = (FloatArray*) self->number_array;
+	if (self->index >= float_array->size)
+		return NULL;
+	return (Object*) new_Float(float_array->array[self->index++]);
+}
+
+Object* NumberArray_iterator(Object* super, Object** args)
+{
+	NumberArrayIterator* iterator = alloc_obj(NumberArrayIterator);
+	iterator->class_ = &NumberArrayIterator_class;
+	iterator->number_array = super;
+	iterator->index = 0;
+	return (Object*) iterator;
+}
+
+
+void NumberArray_init_classes()
+{
+	init_static_class(IntArray);
+	set_builtin_methods(IntArray);
+
+	init_static_class(FloatArray);
+	set_builtin_methods(FloatArray);
+
+	init_static_class(NumberArrayIterator);
+	set_builtin_methods(NumberArrayIterator);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Class.h"
+#include "Object.h"
+#include <stddef.h>
+
+// Arrays of unboxed numbers.  The numbers are stored contiguously, so the
+// reductions ("sum", "min", etc.) are simple loops over memory, which the
+// compiler can vectorize.
+
+typedef struct IntArray {
+	Class* class_;
+	size_t size, capacity;
+	int* array;
+	} IntArray;
+
+typedef struct FloatArray {
+	Class* class_;
+	size_t size, capacity;
+	double* array;
+	} FloatArray;
+
+
+extern IntArray* new_IntArray(size_t size);
+	// The items are all zero.
+extern void IntArray_append(IntArray* self, int value);
+extern FloatArray* new_FloatArray(size_t size);
+	// The items are all zero.
+extern void FloatArray_append(FloatArray* self, double value);
+
+extern Class IntArray_class;
+extern Class FloatArray_class;
+extern void NumberArray_init_classes();
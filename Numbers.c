@@ -0,0 +1,352 @@
+#include "Numbers.h"
+#include "Memory.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+static const char digit_pairs[] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+// All exactly representable as doubles.
+static const double powers_of_10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+	1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+	1e21, 1e22,
+	};
+#define max_exact_power_of_10 22
+#define max_exact_integer 9007199254740992.0 	// 2^53
+
+
+static int format_digits(uint64_t value, char* out)
+{
+	// Two digits at a time, from the end.
+	char buffer[20];
+	char* p = buffer + sizeof(buffer);
+	while (value >= 100) {
+		int pair = (value % 100) * 2;
+		value /= 100;
+		*--p = digit_pairs[pair + 1];
+		*--p = digit_pairs[pair];
+		}
+	if (value >= 10) {
+		int pair = value * 2;
+		*--p = digit_pairs[pair + 1];
+		*--p = digit_pairs[pair];
+		}
+	else
+		*--p = '0' + value;
+	int size = buffer + sizeof(buffer) - p;
+	memcpy(out, p, size);
+	return size;
+}
+
+
+int format_int(int value, char* out)
+{
+	char* p = out;
+	uint32_t magnitude = value;
+	if (value < 0) {
+		*p++ = '-';
+		magnitude = 0u - magnitude;
+		}
+	p += format_digits(magnitude, p);
+	return p - out;
+}
+
+
+static bool shortest_digits_fast(double value, uint64_t* digits_out, int* exponent_out)
+{
+	// "value" is positive.  Finds the fewest decimal places "k" such that
+	// rounding value * 10^k to an integer "r" gives back "value" when divided
+	// by 10^k.  If r < 2^53, both r and 10^k are exact, and IEEE division is
+	// correctly rounded, so r / 10^k is exactly what parsing the decimal
+	// gives.
+	for (int k = 0; k <= max_exact_power_of_10; ++k) {
+		double scaled = value * powers_of_10[k];
+		if (scaled >= max_exact_integer)
+			return false;
+		uint64_t rounded = (uint64_t) (scaled + 0.5);
+		if ((double) rounded / powers_of_10[k] == value) {
+			*digits_out = rounded;
+			*exponent_out = -k;
+			return true;
+			}
+		}
+	return false;
+}
+
+static void shortest_digits_slow(double value, uint64_t* digits_out, int* exponent_out)
+{
+	// Any decimal with up to 15 significant digits survives a trip through a
+	// (normal) double, so if 15 digits don't round-trip, nothing shorter will,
+	// and 17 always do.  Subnormals have less precision, so they start from
+	// one digit.
+	char buffer[40];
+	for (int precision = (value < DBL_MIN ? 0 : 14); ; ++precision) {
+		snprintf(buffer, sizeof(buffer), "%.*e", precision, value);
+		if (precision == 16 || strtod(buffer, NULL) == value)
+			break;
+		}
+
+	// Pick apart "d.ddde+xx".
+	uint64_t digits = 0;
+	int num_fraction_digits = 0;
+	const char* p = buffer;
+	for (; *p != 'e'; ++p) {
+		if (*p == '.')
+			continue;
+		digits = digits * 10 + (*p - '0');
+		num_fraction_digits += 1;
+		}
+	num_fraction_digits -= 1;
+	*digits_out = digits;
+	*exponent_out = atoi(p + 1) - num_fraction_digits;
+}
+
+
+int format_float(double value, char* out)
+{
+	char* p = out;
+	if (signbit(value)) {
+		*p++ = '-';
+		value = -value;
+		}
+	if (isnan(value)) {
+		memcpy(p, "nan", 3);
+		return p + 3 - out;
+		}
+	if (isinf(value)) {
+		memcpy(p, "inf", 3);
+		return p + 3 - out;
+		}
+	if (value == 0.0) {
+		*p++ = '0';
+		return p - out;
+		}
+
+	// Get the digits; value = digits * 10^exponent.
+	uint64_t digits_value;
+	int exponent;
+	if (!shortest_digits_fast(value, &digits_value, &exponent))
+		shortest_digits_slow(value, &digits_value, &exponent);
+	char digits[20];
+	int num_digits = format_digits(digits_value, digits);
+	while (num_digits > 1 && digits[num_digits - 1] == '0') {
+		num_digits -= 1;
+		exponent += 1;
+		}
+
+	// Lay them out like "%g" does, but with at least all the digits.
+	int point_position = exponent + num_digits - 1; 	// The exponent in scientific notation.
+	int precision = (num_digits > 6 ? num_digits : 6);
+	if (point_position < -4 || point_position >= precision) {
+		*p++ = digits[0];
+		if (num_digits > 1) {
+			*p++ = '.';
+			memcpy(p, digits + 1, num_digits - 1);
+			p += num_digits - 1;
+			}
+		*p++ = 'e';
+		*p++ = (point_position < 0 ? '-' : '+');
+		int exponent_magnitude = (point_position < 0 ? -point_position : point_position);
+		if (exponent_magnitude < 10)
+			*p++ = '0';
+		p += format_digits(exponent_magnitude, p);
+		}
+	else if (point_position < 0) {
+		*p++ = '0';
+		*p++ = '.';
+		for (int i = point_position + 1; i < 0; ++i)
+			*p++ = '0';
+		memcpy(p, digits, num_digits);
+		p += num_digits;
+		}
+	else if (num_digits <= point_position + 1) {
+		memcpy(p, digits, num_digits);
+		p += num_digits;
+		for (int i = num_digits; i <= point_position; ++i)
+			*p++ = '0';
+		}
+	else {
+		memcpy(p, digits, point_position + 1);
+		p += point_position + 1;
+		*p++ = '.';
+		memcpy(p, digits + point_position + 1, num_digits - point_position - 1);
+		p += num_digits - point_position - 1;
+		}
+	return p - out;
+}
+
+
+static bool is_space(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static int digit_value(char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	return -1;
+}
+
+
+bool parse_int(const char* str, size_t size, int* value_out)
+{
+	const char* p = str;
+	const char* end = str + size;
+	while (p < end && is_space(*p))
+		p += 1;
+	bool negative = false;
+	if (p < end && (*p == '+' || *p == '-')) {
+		negative = (*p == '-');
+		p += 1;
+		}
+	int base = 10;
+	if (p < end && *p == '0') {
+		if (end - p > 2 && (p[1] == 'x' || p[1] == 'X') && digit_value(p[2]) >= 0) {
+			base = 16;
+			p += 2;
+			}
+		else
+			base = 8;
+		}
+
+	// Like strtol() (with a 64-bit long), out-of-range values are clamped
+	// before they're cut down to an int.
+	const char* digits_start = p;
+	uint64_t limit = (uint64_t) INT64_MAX + negative;
+	uint64_t value = 0;
+	for (; p < end; ++p) {
+		int digit = digit_value(*p);
+		if (digit < 0 || digit >= base)
+			break;
+		if (value > (limit - digit) / base)
+			value = limit;
+		else
+			value = value * base + digit;
+		}
+	if (p == digits_start) {
+		// Like strtol(), an empty string is zero.
+		*value_out = 0;
+		return size == 0;
+		}
+	if (p != end)
+		return false;
+	*value_out = (int) (negative ? 0 - value : value);
+	return true;
+}
+
+
+static bool parse_float_slow(const char* str, size_t size, double* value_out)
+{
+	if (memchr(str, 0, size))
+		return false;
+	char buffer[64];
+	char* c_str = (size < sizeof(buffer) ? buffer : (char*) alloc_mem_no_pointers(size + 1));
+	memcpy(c_str, str, size);
+	c_str[size] = 0;
+	char* end_ptr = NULL;
+	double value = strtod(c_str, &end_ptr);
+	if (*end_ptr != 0)
+		return false;
+	*value_out = value;
+	return true;
+}
+
+bool parse_float(const char* str, size_t size, double* value_out)
+{
+	// Plain decimals with up to 19 significant digits are read into an
+	// integer.  If that's at most 2^53 and the exponent is small enough for
+	// 10^exponent to be exact, one multiplication or division gives the
+	// correctly rounded result (Clinger's fast path).  Anything else (hex
+	// floats, "inf", long or extreme numbers) goes to strtod().
+	const char* p = str;
+	const char* end = str + size;
+	while (p < end && is_space(*p))
+		p += 1;
+	bool negative = false;
+	if (p < end && (*p == '+' || *p == '-')) {
+		negative = (*p == '-');
+		p += 1;
+		}
+
+	uint64_t mantissa = 0;
+	int num_digits = 0, exponent = 0;
+	bool have_digits = false, truncated = false;
+	for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+		have_digits = true;
+		if (mantissa == 0 && *p == '0')
+			continue;
+		if (num_digits < 19) {
+			mantissa = mantissa * 10 + (*p - '0');
+			num_digits += 1;
+			}
+		else {
+			truncated = true;
+			exponent += 1;
+			}
+		}
+	if (p < end && *p == '.') {
+		for (p += 1; p < end && *p >= '0' && *p <= '9'; ++p) {
+			have_digits = true;
+			if (mantissa == 0 && *p == '0') {
+				exponent -= 1;
+				continue;
+				}
+			if (num_digits < 19) {
+				mantissa = mantissa * 10 + (*p - '0');
+				num_digits += 1;
+				exponent -= 1;
+				}
+			else
+				truncated = true;
+			}
+		}
+	if (have_digits && p < end && (*p == 'e' || *p == 'E')) {
+		p += 1;
+		bool negative_exponent = false;
+		if (p < end && (*p == '+' || *p == '-')) {
+			negative_exponent = (*p == '-');
+			p += 1;
+			}
+		if (p >= end || *p < '0' || *p > '9')
+			return false;
+		int explicit_exponent = 0;
+		for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+			if (explicit_exponent < 100000)
+				explicit_exponent = explicit_exponent * 10 + (*p - '0');
+			}
+		exponent += (negative_exponent ? -explicit_exponent : explicit_exponent);
+		}
+
+	if (!have_digits || p != end || truncated)
+		return parse_float_slow(str, size, value_out);
+	double value;
+	if (mantissa == 0)
+		value = 0.0;
+	else if (mantissa > (uint64_t) max_exact_integer || exponent < -max_exact_power_of_10 || exponent > max_exact_power_of_10)
+		return parse_float_slow(str, size, value_out);
+	else if (exponent < 0)
+		value = (double) mantissa / powers_of_10[-exponent];
+	else
+		value = (double) mantissa * powers_of_10[exponent];
+	*value_out = (negative ? -value : value);
+	return true;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+
+// Converting numbers to and from text, without going through the C library
+// (except for the rare Floats the fast paths can't handle).  The formatters
+// write into "out" (which isn't NUL-terminated) and return the number of
+// bytes written.  The parsers take the whole of "str", which needn't be
+// NUL-terminated, and return false if it isn't a valid number.
+
+#define max_formatted_int_size 12
+#define max_formatted_float_size 32
+
+extern int format_int(int value, char* out);
+extern int format_float(double value, char* out);
+	// The shortest digits that read back as the same Float, laid out the way
+	// printf()'s "%g" does.
+extern bool parse_int(const char* str, size_t size, int* value_out);
+	// Accepts what strtol() does with a base of zero: leading whitespace, a
+	// sign, and "0x" (hex) or "0" (octal) prefixes.
+extern bool parse_float(const char* str, size_t size, double* value_out);
+	// Accepts what strtod() does.
@@ -128,15 +128,7 @@ void Object_init_class()
 	init_static_class(Object);
 	Object_class.superclass = NULL;
 
-	static BuiltinMethodSpec builtin_methods[] = {
-		{ "string", 0, Object_string },
-		{ "==", 1, Object_equals },
-		{ "!=", 1, Object_not_equals },
-		{ "is-a", 1, Object_is_a },
-		{ "class", 0, Object_class_builtin },
-		{ NULL, 0, NULL },
-		};
-	Class_add_builtin_methods(&Object_class, builtin_methods);
+	set_builtin_methods(Object);
 }
 
 
@@ -4,6 +4,7 @@
 #include "Environment.h"
 #include "Upvalues.h"
 #include "Module.h"
+#include "Method.h"
 #include "ByteArray.h"
 #include "Array.h"
 #include "String.h"
@@ -12,6 +13,8 @@
 #include "Int.h"
 #include "Float.h"
 #include "ByteCode.h"
+#include "Region.h"
+#include "Numbers.h"
 #include "Memory.h"
 #include "Error.h"
 #include <stdlib.h>
@@ -23,11 +26,13 @@ int Block_emit(struct ParseNode* super, struct MethodBuilder* method)
 	Block* self = (Block*) super;
 
 	// Push our context.
-	BlockContext context;
-	BlockContext_init(&context, self, method->environment);
+	// Contexts are allocated rather than on the stack, because lazily-compiled
+	// functions hold on to them.
+	BlockContext* context = alloc_compiler_obj(BlockContext);
+	BlockContext_init(context, self, method->environment);
 	if (self->module)
-		BlockContext_make_module_context(&context);
-	method->environment = &context.environment;
+		BlockContext_make_module_context(context);
+	method->environment = &context->environment;
 
 	// First, resolve names, so our locals get autodeclared.
 	// This is a per-block operation.  The ParseNodes don't need to descend into
@@ -56,39 +61,42 @@ int Block_emit(struct ParseNode* super, struct MethodBuilder* method)
 		ParseNode* statement = (ParseNode*) Array_at(self->statements, i);
 		if (statement->type == PN_FunctionStatement) {
 			// Function.  Add upvalues to the context.
-			BlockUpvalueContext context;
-			BlockUpvalueContext_init(&context, self, method, method->environment);
+			BlockUpvalueContext* context = alloc_compiler_obj(BlockUpvalueContext);
+			BlockUpvalueContext_init(context, self, method, method->environment);
 			if (self->module)
-				BlockUpvalueContext_make_module_context(&context);
-			method->environment = &context.environment;
+				BlockUpvalueContext_make_module_context(context);
+			method->environment = &context->environment;
 
+			// Compile it lazily, unless we need to dump it now.
 			FunctionStatement* function = (FunctionStatement*) statement;
-			Object* compiled_method = FunctionStatement_compile(function, method->environment);
 			if (dump_requested) {
+				Object* compiled_method = FunctionStatement_compile(function, method->environment);
 				dump_bytecode((struct Method*) compiled_method, NULL, function->name);
 				printf("\n");
 				}
+			else
+				FunctionStatement_compile_lazily(function, method->environment);
 
-			method->environment = context.environment.parent;
+			method->environment = context->environment.parent;
 			}
 		else if (statement->type == PN_ClassStatement) {
 			// Class.  Add upvalues to the context.
-			BlockUpvalueContext context;
-			BlockUpvalueContext_init(&context, self, method, method->environment);
+			BlockUpvalueContext* context = alloc_compiler_obj(BlockUpvalueContext);
+			BlockUpvalueContext_init(context, self, method, method->environment);
 			if (self->module)
-				BlockUpvalueContext_make_module_context(&context);
-			method->environment = &context.environment;
+				BlockUpvalueContext_make_module_context(context);
+			method->environment = &context->environment;
 
 			statement->emit(statement, method);
 
-			method->environment = context.environment.parent;
+			method->environment = context->environment.parent;
 			}
 		else
 			statement->emit(statement, method);
 		}
 
 	// Pop our context.
-	method->environment = context.environment.parent;
+	method->environment = context->environment.parent;
 
 	method->cur_num_variables = self->locals_base;
 	return -1;
@@ -96,7 +104,7 @@ int Block_emit(struct ParseNode* super, struct MethodBuilder* method)
 
 Block* new_Block()
 {
-	Block* block = alloc_obj(Block);
+	Block* block = alloc_compiler_obj(Block);
 	block->parse_node.emit = Block_emit;
 	block->statements = new_Array();
 	return block;
@@ -239,7 +247,7 @@ void IfStatement_resolve_names(ParseNode* super, MethodBuilder* method)
 
 IfStatement* new_IfStatement()
 {
-	IfStatement* if_statement = alloc_obj(IfStatement);
+	IfStatement* if_statement = alloc_compiler_obj(IfStatement);
 	if_statement->parse_node.type = PN_IfStatement;
 	if_statement->parse_node.emit = IfStatement_emit;
 	if_statement->parse_node.resolve_names = IfStatement_resolve_names;
@@ -290,7 +298,7 @@ void WhileStatement_resolve_names(ParseNode* super, MethodBuilder* method)
 
 WhileStatement* new_WhileStatement()
 {
-	WhileStatement* self = alloc_obj(WhileStatement);
+	WhileStatement* self = alloc_compiler_obj(WhileStatement);
 	self->parse_node.emit = WhileStatement_emit;
 	self->parse_node.resolve_names = WhileStatement_resolve_names;
 	return self;
@@ -346,9 +354,9 @@ int ForStatement_emit(ParseNode* super, MethodBuilder* method)
 	int value_loc = emit_call(iterator_loc, "next", 0, NULL, method);
 
 	// Context.
-	ForStatementContext context;
-	ForStatementContext_init(&context, self->variable_name, value_loc);
-	MethodBuilder_push_environment(method, &context.environment);
+	ForStatementContext* context = alloc_compiler_obj(ForStatementContext);
+	ForStatementContext_init(context, self->variable_name, value_loc);
+	MethodBuilder_push_environment(method, &context->environment);
 
 	// Test.
 	MethodBuilder_add_bytecode(method, BC_BRANCH_IF_NIL);
@@ -381,7 +389,7 @@ void ForStatement_resolve_names(ParseNode* super, MethodBuilder* method)
 
 ForStatement* new_ForStatement()
 {
-	ForStatement* self = alloc_obj(ForStatement);
+	ForStatement* self = alloc_compiler_obj(ForStatement);
 	self->parse_node.emit = ForStatement_emit;
 	self->parse_node.resolve_names = ForStatement_resolve_names;
 	return self;
@@ -398,7 +406,7 @@ int ContinueStatement_emit(ParseNode* self, MethodBuilder* method)
 
 ParseNode* new_ContinueStatement()
 {
-	ParseNode* self = alloc_obj(ParseNode);
+	ParseNode* self = alloc_compiler_obj(ParseNode);
 	self->emit = ContinueStatement_emit;
 	return self;
 }
@@ -414,7 +422,7 @@ int BreakStatement_emit(ParseNode* self, MethodBuilder* method)
 
 ParseNode* new_BreakStatement()
 {
-	ParseNode* self = alloc_obj(ParseNode);
+	ParseNode* self = alloc_compiler_obj(ParseNode);
 	self->emit = BreakStatement_emit;
 	return self;
 }
@@ -448,7 +456,7 @@ void ReturnStatement_resolve_names(ParseNode* super, MethodBuilder* method)
 
 ReturnStatement* new_ReturnStatement()
 {
-	ReturnStatement* self = alloc_obj(ReturnStatement);
+	ReturnStatement* self = alloc_compiler_obj(ReturnStatement);
 	self->parse_node.emit = ReturnStatement_emit;
 	self->parse_node.resolve_names = ReturnStatement_resolve_names;
 	return self;
@@ -468,9 +476,9 @@ int WithStatement_emit(ParseNode* super, MethodBuilder* method)
 	method->cur_num_variables = self->variable_loc + 1;
 
 	// Our context is just like a ForStatement_emit, we'll just leech off of that.
-	ForStatementContext context;
-	ForStatementContext_init(&context, self->name, self->variable_loc);
-	MethodBuilder_push_environment(method, &context.environment);
+	ForStatementContext* context = alloc_compiler_obj(ForStatementContext);
+	ForStatementContext_init(context, self->name, self->variable_loc);
+	MethodBuilder_push_environment(method, &context->environment);
 	MethodBuilder_push_unwind_point(method, &self->parse_node);
 
 	// Emit the body.
@@ -495,7 +503,7 @@ void WithStatement_resolve_names(ParseNode* super, MethodBuilder* method)
 
 WithStatement* new_WithStatement(String* name, ParseNode* value, ParseNode* body)
 {
-	WithStatement* self = alloc_obj(WithStatement);
+	WithStatement* self = alloc_compiler_obj(WithStatement);
 	self->parse_node.type = PN_WithStatement;
 	self->parse_node.emit = WithStatement_emit;
 	self->parse_node.resolve_names = WithStatement_resolve_names;
@@ -520,7 +528,7 @@ int FunctionStatement_emit(ParseNode* super, MethodBuilder* method)
 
 FunctionStatement* new_FunctionStatement(struct String* name)
 {
-	FunctionStatement* self = alloc_obj(FunctionStatement);
+	FunctionStatement* self = alloc_compiler_obj(FunctionStatement);
 	self->parse_node.type = PN_FunctionStatement;
 	self->parse_node.emit = FunctionStatement_emit;
 	self->name = name;
@@ -531,8 +539,25 @@ FunctionStatement* new_FunctionStatement(struct String* name)
 
 Object* FunctionStatement_compile(FunctionStatement* self, Environment* environment)
 {
-	// Compile.
-	MethodBuilder* builder = new_MethodBuilder(self->arguments, environment);
+	Method* method = new_Method(self->arguments->size);
+	self->compiled_method = (Object*) method;
+	FunctionStatement_patch_references(self);
+	FunctionStatement_compile_into(self, environment, method);
+	return self->compiled_method;
+}
+
+Object* FunctionStatement_compile_lazily(FunctionStatement* self, Environment* environment)
+{
+	// The stub will compile itself the first time it's called.  Everything
+	// that refers to the function can use the stub in the meantime.
+	self->compiled_method = (Object*) new_stub_Method(self, environment);
+	FunctionStatement_patch_references(self);
+	return self->compiled_method;
+}
+
+void FunctionStatement_compile_into(FunctionStatement* self, Environment* environment, Method* method)
+{
+	MethodBuilder* builder = new_MethodBuilder_for_method(method, self->arguments, environment);
 	MethodBuilder_add_literal(builder, (Object*) self->name);
 	if (self->body)
 		self->body->emit(self->body, builder);
@@ -540,17 +565,16 @@ Object* FunctionStatement_compile(FunctionStatement* self, Environment* environm
 		MethodBuilder_finish_init(builder);
 	else
 		MethodBuilder_finish(builder);
-	self->compiled_method = (Object*) builder->method;
+}
 
-	// Patch up previous references.
+void FunctionStatement_patch_references(FunctionStatement* self)
+{
 	UpvalueFunction* reference = self->pending_references;
 	while (reference) {
 		UpvalueFunction_patch(reference, self->compiled_method);
 		reference = reference->next_pending_reference;
 		}
 	self->pending_references = NULL;
-
-	return self->compiled_method;
 }
 
 void FunctionStatement_add_reference(FunctionStatement* self, struct UpvalueFunction* reference)
@@ -584,7 +608,7 @@ int UpvalueFunction_emit(ParseNode* super, MethodBuilder* method)
 
 UpvalueFunction* new_UpvalueFunction(FunctionStatement* function)
 {
-	UpvalueFunction* self = alloc_obj(UpvalueFunction);
+	UpvalueFunction* self = alloc_compiler_obj(UpvalueFunction);
 	self->parse_node.emit = UpvalueFunction_emit;
 	self->function = function;
 	return self;
@@ -614,7 +638,7 @@ void ExpressionStatement_resolve_names(ParseNode* super, MethodBuilder* method)
 
 ExpressionStatement* new_ExpressionStatement(ParseNode* expression)
 {
-	ExpressionStatement* self = alloc_obj(ExpressionStatement);
+	ExpressionStatement* self = alloc_compiler_obj(ExpressionStatement);
 	self->parse_node.emit = ExpressionStatement_emit;
 	self->parse_node.resolve_names = ExpressionStatement_resolve_names;
 	self->expression = expression;
@@ -641,7 +665,7 @@ void SetExpr_resolve_names(ParseNode* super, MethodBuilder* method)
 
 SetExpr* new_SetExpr()
 {
-	SetExpr* self = alloc_obj(SetExpr);
+	SetExpr* self = alloc_compiler_obj(SetExpr);
 	self->parse_node.emit = SetExpr_emit;
 	self->parse_node.resolve_names = SetExpr_resolve_names;
 	return self;
@@ -690,7 +714,7 @@ void ShortCircuitExpr_resolve_names(ParseNode* super, MethodBuilder* method)
 
 ShortCircuitExpr* new_ShortCircuitExpr(ParseNode* expr1, ParseNode* expr2, bool is_and)
 {
-	ShortCircuitExpr* self = alloc_obj(ShortCircuitExpr);
+	ShortCircuitExpr* self = alloc_compiler_obj(ShortCircuitExpr);
 	self->parse_node.emit = ShortCircuitExpr_emit;
 	self->parse_node.resolve_names = ShortCircuitExpr_resolve_names;
 	self->expr1 = expr1;
@@ -726,7 +750,7 @@ void ShortCircuitNot_resolve_names(ParseNode* super, MethodBuilder* method)
 
 ShortCircuitNot* new_ShortCircuitNot(ParseNode* expr)
 {
-	ShortCircuitNot* self = alloc_obj(ShortCircuitNot);
+	ShortCircuitNot* self = alloc_compiler_obj(ShortCircuitNot);
 	self->parse_node.emit = ShortCircuitNot_emit;
 	self->parse_node.resolve_names = ShortCircuitNot_resolve_names;
 	self->expr = expr;
@@ -742,7 +766,7 @@ int StringLiteralExpr_emit(ParseNode* super, MethodBuilder* method)
 
 StringLiteralExpr* new_StringLiteralExpr(struct String* str)
 {
-	StringLiteralExpr* self = alloc_obj(StringLiteralExpr);
+	StringLiteralExpr* self = alloc_compiler_obj(StringLiteralExpr);
 	self->parse_node.emit = StringLiteralExpr_emit;
 	self->str = str;
 	return self;
@@ -791,7 +815,7 @@ void InterpolatedStringLiteral_resolve_names(ParseNode* super, MethodBuilder* me
 
 InterpolatedStringLiteral* new_InterpolatedStringLiteral(struct Array* components)
 {
-	InterpolatedStringLiteral* self = alloc_obj(InterpolatedStringLiteral);
+	InterpolatedStringLiteral* self = alloc_compiler_obj(InterpolatedStringLiteral);
 	self->parse_node.emit = InterpolatedStringLiteral_emit;
 	self->parse_node.resolve_names = InterpolatedStringLiteral_resolve_names;
 	self->components = components;
@@ -807,9 +831,12 @@ int IntLiteralExpr_emit(ParseNode* super, MethodBuilder* method)
 
 IntLiteralExpr* new_IntLiteralExpr(String* value_str)
 {
-	IntLiteralExpr* self = alloc_obj(IntLiteralExpr);
+	IntLiteralExpr* self = alloc_compiler_obj(IntLiteralExpr);
 	self->parse_node.emit = IntLiteralExpr_emit;
-	self->value = strtol(String_c_str(value_str), NULL, 0);
+	if (!parse_int(value_str->str, value_str->size, &self->value)) {
+		// Malformed literals (like "09") get whatever prefix strtol() takes.
+		self->value = strtol(String_c_str(value_str), NULL, 0);
+		}
 	return self;
 }
 
@@ -822,9 +849,10 @@ int FloatLiteralExpr_emit(ParseNode* super, MethodBuilder* method)
 
 FloatLiteralExpr* new_FloatLiteralExr(struct String* value_str)
 {
-	FloatLiteralExpr* self = alloc_obj(FloatLiteralExpr);
+	FloatLiteralExpr* self = alloc_compiler_obj(FloatLiteralExpr);
 	self->parse_node.emit = FloatLiteralExpr_emit;
-	self->value = strtod(String_c_str(value_str), NULL);
+	if (!parse_float(value_str->str, value_str->size, &self->value))
+		self->value = strtod(String_c_str(value_str), NULL);
 	return self;
 }
 
@@ -840,7 +868,7 @@ int BooleanLiteral_emit(ParseNode* super, MethodBuilder* method)
 
 BooleanLiteral* new_BooleanLiteral(bool value)
 {
-	BooleanLiteral* self = alloc_obj(BooleanLiteral);
+	BooleanLiteral* self = alloc_compiler_obj(BooleanLiteral);
 	self->parse_node.emit = BooleanLiteral_emit;
 	self->value = value;
 	return self;
@@ -857,7 +885,7 @@ int NilLiteral_emit(ParseNode* self, MethodBuilder* method)
 
 ParseNode* new_NilLiteral()
 {
-	ParseNode* self = alloc_obj(ParseNode);
+	ParseNode* self = alloc_compiler_obj(ParseNode);
 	self->emit = NilLiteral_emit;
 	return self;
 }
@@ -871,7 +899,7 @@ int GlobalExpr_emit(ParseNode* super, MethodBuilder* method)
 
 GlobalExpr* new_GlobalExpr(struct Object* object)
 {
-	GlobalExpr* self = alloc_obj(GlobalExpr);
+	GlobalExpr* self = alloc_compiler_obj(GlobalExpr);
 	self->parse_node.emit = GlobalExpr_emit;
 	self->object = object;
 	return self;
@@ -916,7 +944,7 @@ int Variable_emit_set(ParseNode* super, ParseNode* value, MethodBuilder* method)
 
 Variable* new_Variable(struct String* name, int line_number, struct String* filename)
 {
-	Variable* self = alloc_obj(Variable);
+	Variable* self = alloc_compiler_obj(Variable);
 	self->parse_node.type = PN_Variable;
 	self->parse_node.emit = Variable_emit;
 	self->parse_node.emit_set = Variable_emit_set;
@@ -949,7 +977,7 @@ int Local_emit_set(ParseNode* super, ParseNode* value, MethodBuilder* method)
 
 Local* new_Local(Block* block, int block_index)
 {
-	Local* self = alloc_obj(Local);
+	Local* self = alloc_compiler_obj(Local);
 	self->parse_node.type = PN_Local;
 	self->parse_node.emit = Local_emit;
 	self->parse_node.emit_set = Local_emit_set;
@@ -966,7 +994,7 @@ int SelfExpr_emit(ParseNode* super, MethodBuilder* method)
 
 SelfExpr* new_SelfExpr()
 {
-	SelfExpr* self = (SelfExpr*) alloc_obj(SelfExpr);
+	SelfExpr* self = (SelfExpr*) alloc_compiler_obj(SelfExpr);
 	self->parse_node.emit = SelfExpr_emit;
 	return self;
 }
@@ -997,7 +1025,7 @@ int RawLoc_emit_set(ParseNode* super, ParseNode* value, MethodBuilder* method)
 
 RawLoc* new_RawLoc(int loc)
 {
-	RawLoc* self = alloc_obj(RawLoc);
+	RawLoc* self = alloc_compiler_obj(RawLoc);
 	self->parse_node.emit = RawLoc_emit;
 	self->parse_node.emit_set = RawLoc_emit_set;
 	self->loc = loc;
@@ -1038,7 +1066,7 @@ void ArrayLiteral_resolve_names(ParseNode* super, MethodBuilder* method)
 
 ArrayLiteral* new_ArrayLiteral()
 {
-	ArrayLiteral* self = alloc_obj(ArrayLiteral);
+	ArrayLiteral* self = alloc_compiler_obj(ArrayLiteral);
 	self->parse_node.emit = ArrayLiteral_emit;
 	self->parse_node.resolve_names = ArrayLiteral_resolve_names;
 	self->items = new_Array();
@@ -1070,7 +1098,7 @@ int DictLiteral_emit(ParseNode* super, MethodBuilder* method)
 		ParseNode* value = (ParseNode*) item.value;
 
 		int value_loc = value->emit(value, method);
-		int name_loc = MethodBuilder_emit_string_literal(method, item.key);
+		int name_loc = MethodBuilder_emit_string_literal(method, (String*) item.key);
 
 		MethodBuilder_add_bytecode(method, BC_DICT_ADD);
 		MethodBuilder_add_bytecode(method, dict_loc);
@@ -1098,7 +1126,7 @@ void DictLiteral_resolve_names(ParseNode* super, MethodBuilder* method)
 
 DictLiteral* new_DictLiteral()
 {
-	DictLiteral* self = alloc_obj(DictLiteral);
+	DictLiteral* self = alloc_compiler_obj(DictLiteral);
 	self->parse_node.emit = DictLiteral_emit;
 	self->parse_node.resolve_names = DictLiteral_resolve_names;
 	self->items = new_Dict();
@@ -1180,7 +1208,7 @@ void CallExpr_resolve_names(ParseNode* super, MethodBuilder* method)
 
 CallExpr* new_CallExpr(ParseNode* receiver, String* name)
 {
-	CallExpr* self = alloc_obj(CallExpr);
+	CallExpr* self = alloc_compiler_obj(CallExpr);
 	self->parse_node.type = PN_CallExpr;
 	self->parse_node.emit = CallExpr_emit;
 	self->parse_node.emit_set = CallExpr_emit_set;
@@ -1274,7 +1302,7 @@ void FunctionCallExpr_resolve_names(ParseNode* super, MethodBuilder* method)
 
 FunctionCallExpr* new_FunctionCallExpr(ParseNode* fn, struct Array* arguments)
 {
-	FunctionCallExpr* self = alloc_obj(FunctionCallExpr);
+	FunctionCallExpr* self = alloc_compiler_obj(FunctionCallExpr);
 	self->parse_node.type = PN_FunctionCallExpr;
 	self->parse_node.emit = FunctionCallExpr_emit;
 	self->parse_node.resolve_names = FunctionCallExpr_resolve_names;
@@ -1351,7 +1379,7 @@ void SuperCallExpr_resolve_names(ParseNode* super, MethodBuilder* builder)
 
 SuperCallExpr* new_SuperCallExpr(struct String* name)
 {
-	SuperCallExpr* self = alloc_obj(SuperCallExpr);
+	SuperCallExpr* self = alloc_compiler_obj(SuperCallExpr);
 	self->parse_node.emit = SuperCallExpr_emit;
 	self->parse_node.emit_set = SuperCallExpr_emit_set;
 	self->parse_node.resolve_names = SuperCallExpr_resolve_names;
@@ -10,6 +10,7 @@ struct FunctionStatement;
 struct ClassStatement;
 struct UpvalueFunction;
 struct Environment;
+struct Method;
 
 
 // Types.
@@ -118,6 +119,10 @@ typedef struct FunctionStatement {
 	} FunctionStatement;
 extern FunctionStatement* new_FunctionStatement(struct String* name);
 extern struct Object* FunctionStatement_compile(FunctionStatement* self, struct Environment* environment);
+extern struct Object* FunctionStatement_compile_lazily(FunctionStatement* self, struct Environment* environment);
+	// Returns a stub Method, which compiles itself the first time it's called.
+extern void FunctionStatement_compile_into(FunctionStatement* self, struct Environment* environment, struct Method* method);
+extern void FunctionStatement_patch_references(FunctionStatement* self);
 extern void FunctionStatement_add_reference(FunctionStatement* self, struct UpvalueFunction* reference);
 
 typedef struct UpvalueFunction {
@@ -7,6 +7,7 @@
 #include "String.h"
 #include "Array.h"
 #include "Object.h"
+#include "Region.h"
 #include "Memory.h"
 #include "UTF8.h"
 #include "Error.h"
@@ -38,13 +39,12 @@ extern ParseNode* Parser_parse_primary_expression(Parser* self);
 extern ParseNode* Parser_parse_array_literal(Parser* self);
 extern ParseNode* Parser_parse_dict_literal(Parser* self);
 extern ParseNode* Parser_parse_super_call(Parser* self);
-extern bool String_is_one_of(String* str, const char** values);
 extern const char* where(int line_number, struct String* filename);
 
 
 Parser* new_Parser(const char* text, size_t size, struct String* filename)
 {
-	Parser* parser = (Parser*) alloc_mem(sizeof(Parser));
+	Parser* parser = alloc_compiler_obj(Parser);
 	parser->lexer = new_Lexer(text, size, filename);
 	parser->filename = filename;
 	return parser;
@@ -97,22 +97,22 @@ ParseNode* Parser_parse_block(Parser* self, Module* module)
 
 
 typedef struct {
-	const char* name;
+	TokenKind kind;
 	ParseNode* (*fn)(Parser* self);
 	} StatementParser;
 static StatementParser statement_parsers[] = {
-	{ "if", &Parser_parse_if_statement },
-	{ "while", &Parser_parse_while_statement },
-	{ "for", &Parser_parse_for_statement },
-	{ "continue", &Parser_parse_continue_statement },
-	{ "break", &Parser_parse_break_statement },
-	{ "return", &Parser_parse_return_statement },
-	{ "with", &Parser_parse_with_statement },
-	{ "fn", &Parser_parse_fn_statement },
-	{ "class", &Parser_parse_class_statement },
-	{ "$", &Parser_parse_run_statement },
-	{ "import", &Parser_parse_import },
-	{ "export", &Parser_parse_export },
+	{ K_IF, &Parser_parse_if_statement },
+	{ K_WHILE, &Parser_parse_while_statement },
+	{ K_FOR, &Parser_parse_for_statement },
+	{ K_CONTINUE, &Parser_parse_continue_statement },
+	{ K_BREAK, &Parser_parse_break_statement },
+	{ K_RETURN, &Parser_parse_return_statement },
+	{ K_WITH, &Parser_parse_with_statement },
+	{ K_FN, &Parser_parse_fn_statement },
+	{ K_CLASS, &Parser_parse_class_statement },
+	{ K_DOLLAR, &Parser_parse_run_statement },
+	{ K_IMPORT, &Parser_parse_import },
+	{ K_EXPORT, &Parser_parse_export },
 	};
 
 ParseNode* Parser_parse_statement(Parser* self)
@@ -125,7 +125,7 @@ ParseNode* Parser_parse_statement(Parser* self)
 
 	if (next_token.type == Identifier) {
 		for (int i = 0; i < sizeof(statement_parsers) / sizeof(statement_parsers[0]); ++i) {
-			if (String_equals_c(next_token.token, statement_parsers[i].name))
+			if (next_token.kind == statement_parsers[i].kind)
 				return statement_parsers[i].fn(self);
 			}
 		}
@@ -161,10 +161,10 @@ ParseNode* Parser_parse_if_statement(Parser* self)
 		next_token = Lexer_peek(self->lexer);
 		}
 	if (next_token.type == Identifier) {
-		if (String_equals_c(next_token.token, "else")) {
+		if (next_token.kind == K_ELSE) {
 			Lexer_next(self->lexer);
 			next_token = Lexer_peek(self->lexer);
-			if (next_token.type == Identifier && String_equals_c(next_token.token, "if"))
+			if (next_token.type == Identifier && next_token.kind == K_IF)
 				statement->else_block = Parser_parse_if_statement(self);
 			else {
 				if (next_token.type != EOL)
@@ -176,7 +176,7 @@ ParseNode* Parser_parse_if_statement(Parser* self)
 					}
 				}
 			}
-		else if (String_equals_c(next_token.token, "elif")) {
+		else if (next_token.kind == K_ELIF) {
 			// Don't consume the "elif", the recursive call will do that.
 			statement->else_block = Parser_parse_if_statement(self);
 			}
@@ -215,7 +215,7 @@ ParseNode* Parser_parse_for_statement(Parser* self)
 	ForStatement* statement = new_ForStatement();
 	statement->variable_name = token.token;
 	token = Lexer_next(self->lexer);
-	if (token.type != Operator || !String_equals_c(token.token, ":"))
+	if (token.type != Operator || token.kind != K_COLON)
 		Error("Missing \":\" in \"for\" statement %s.", where(line_number, self->filename));
 	statement->collection = Parser_parse_expression(self);
 	if (statement->collection == NULL)
@@ -272,7 +272,7 @@ ParseNode* Parser_parse_with_statement(Parser* self)
 		Error("Expected a name in \"with\" statement %s.", where(token.line_number, self->filename));
 	String* name = token.token;
 	token = Lexer_next(self->lexer);
-	if (token.type != Operator || !String_equals_c(token.token, "="))
+	if (token.type != Operator || token.kind != K_ASSIGN)
 		Error("Expected \"=\"  in \"with\" statement %s.", where(token.line_number, self->filename));
 	ParseNode* expr = Parser_parse_expression(self);
 	if (expr == NULL)
@@ -330,9 +330,10 @@ ParseNode* Parser_parse_fn_statement(Parser* self)
 
 ParseNode* Parser_parse_expression(Parser* self)
 {
-	static const char* modify_tokens[] = {
-		"+=", "-=", "*=", "/=", "%=", "<<=", ">>=", "|=", "&=", "^=",
-		NULL
+	static const TokenKind modify_tokens[] = {
+		K_PLUS_ASSIGN, K_MINUS_ASSIGN, K_TIMES_ASSIGN, K_DIVIDE_ASSIGN, K_MOD_ASSIGN,
+		K_SHL_ASSIGN, K_SHR_ASSIGN, K_OR_ASSIGN, K_AND_ASSIGN, K_XOR_ASSIGN,
+		K_NONE
 		};
 
 	ParseNode* expr = Parser_parse_logical_or_expression(self);
@@ -342,7 +343,7 @@ ParseNode* Parser_parse_expression(Parser* self)
 	Token next_token = Lexer_peek(self->lexer);
 	if (next_token.type == Operator) {
 		// "="
-		if (String_equals_c(next_token.token, "=")) {
+		if (next_token.kind == K_ASSIGN) {
 			Lexer_next(self->lexer);
 			if (!expr->emit_set)
 				Error("Attempt to set something that isn't settable %s.", where(next_token.line_number, self->filename));
@@ -356,7 +357,7 @@ ParseNode* Parser_parse_expression(Parser* self)
 			}
 
 		// "+=", etc.
-		else if (String_is_one_of(next_token.token, modify_tokens)) {
+		else if (TokenKind_is_one_of(next_token.kind, modify_tokens)) {
 			Lexer_next(self->lexer);
 			if (!expr->emit_set)
 				Error("Attempt to set something that isn't settable %s.", where(next_token.line_number, self->filename));
@@ -388,7 +389,7 @@ ParseNode* Parser_parse_logical_or_expression(Parser* self)
 
 	while (true) {
 		Token next_token = Lexer_peek(self->lexer);
-		if (next_token.type != Operator || !String_equals_c(next_token.token, "||"))
+		if (next_token.type != Operator || next_token.kind != K_OR)
 			break;
 		Lexer_next(self->lexer);
 
@@ -410,7 +411,7 @@ ParseNode* Parser_parse_logical_and_expression(Parser* self)
 
 	while (true) {
 		Token next_token = Lexer_peek(self->lexer);
-		if (next_token.type != Operator || !String_equals_c(next_token.token, "&&"))
+		if (next_token.type != Operator || next_token.kind != K_AND)
 			break;
 		Lexer_next(self->lexer);
 
@@ -424,20 +425,10 @@ ParseNode* Parser_parse_logical_and_expression(Parser* self)
 }
 
 
-bool String_is_one_of(String* str, const char** values)
-{
-	for (const char** value = values; *value; ++value) {
-		if (String_equals_c(str, *value))
-			return true;
-		}
-	return false;
-}
-
-
 ParseNode* Parser_parse_binop(
 	Parser* self,
 	ParseNode* (*parse_tighter)(Parser* self),
-	const char** tokens)
+	const TokenKind* tokens)
 {
 	ParseNode* expr = parse_tighter(self);
 	if (expr == NULL)
@@ -446,7 +437,7 @@ ParseNode* Parser_parse_binop(
 	while (true) {
 		// Is the next token one of the ones we're looking for?
 		Token op = Lexer_peek(self->lexer);
-		if (op.type != Operator || !String_is_one_of(op.token, tokens))
+		if (op.type != Operator || !TokenKind_is_one_of(op.kind, tokens))
 			break;
 
 		// Parse the argument.
@@ -465,21 +456,21 @@ ParseNode* Parser_parse_binop(
 
 ParseNode* Parser_parse_inclusive_or_expression(Parser* self)
 {
-	static const char* tokens[] = { "|", NULL };
+	static const TokenKind tokens[] = { K_BIT_OR, K_NONE };
 	return Parser_parse_binop(self, Parser_parse_exclusive_or_expression, tokens);
 }
 
 
 ParseNode* Parser_parse_exclusive_or_expression(Parser* self)
 {
-	static const char* tokens[] = { "^", NULL };
+	static const TokenKind tokens[] = { K_XOR, K_NONE };
 	return Parser_parse_binop(self, Parser_parse_and_expression, tokens);
 }
 
 
 ParseNode* Parser_parse_and_expression(Parser* self)
 {
-	static const char* tokens[] = { "&", NULL };
+	static const TokenKind tokens[] = { K_BIT_AND, K_NONE };
 	return Parser_parse_binop(self, Parser_parse_equality_expression, tokens);
 }
 
@@ -492,7 +483,7 @@ ParseNode* Parser_parse_equality_expression(Parser* self)
 
 	while (true) {
 		Token op = Lexer_peek(self->lexer);
-		if (op.type != Operator || (!String_equals_c(op.token, "==") && !String_equals_c(op.token, "!=")))
+		if (op.type != Operator || (op.kind != K_EQ && op.kind != K_NE))
 			return expr;
 		Lexer_next(self->lexer);
 		ParseNode* expr2 = Parser_parse_relational_expression(self);
@@ -511,39 +502,39 @@ ParseNode* Parser_parse_equality_expression(Parser* self)
 
 ParseNode* Parser_parse_relational_expression(Parser* self)
 {
-	static const char* tokens[] = { "<", ">", "<=", ">=", NULL };
+	static const TokenKind tokens[] = { K_LT, K_GT, K_LE, K_GE, K_NONE };
 	return Parser_parse_binop(self, Parser_parse_shift_expression, tokens);
 }
 
 
 ParseNode* Parser_parse_shift_expression(Parser* self)
 {
-	static const char* tokens[] = { "<<", ">>", NULL };
+	static const TokenKind tokens[] = { K_SHL, K_SHR, K_NONE };
 	return Parser_parse_binop(self, Parser_parse_additive_expression, tokens);
 }
 
 
 ParseNode* Parser_parse_additive_expression(Parser* self)
 {
-	static const char* tokens[] = { "+", "-", NULL };
+	static const TokenKind tokens[] = { K_PLUS, K_MINUS, K_NONE };
 	return Parser_parse_binop(self, Parser_parse_multiplicative_expression, tokens);
 }
 
 
 ParseNode* Parser_parse_multiplicative_expression(Parser* self)
 {
-	static const char* tokens[] = { "*", "/", "%", NULL };
+	static const TokenKind tokens[] = { K_TIMES, K_DIVIDE, K_MOD, K_NONE };
 	return Parser_parse_binop(self, Parser_parse_unary_expression, tokens);
 }
 
 
 ParseNode* Parser_parse_unary_expression(Parser* self)
 {
-	static const char* tokens[] = { "~", "-", NULL };
+	static const TokenKind tokens[] = { K_TILDE, K_MINUS, K_NONE };
 
 	Token next_token = Lexer_peek(self->lexer);
 	if (next_token.type == Operator) {
-		if (String_equals_c(next_token.token, "!")) {
+		if (next_token.kind == K_NOT) {
 			Lexer_next(self->lexer);
 			ParseNode* expr = Parser_parse_unary_expression(self);
 			if (expr == NULL)
@@ -551,7 +542,7 @@ ParseNode* Parser_parse_unary_expression(Parser* self)
 			return (ParseNode*) new_ShortCircuitNot(expr);
 			}
 
-		else if (String_is_one_of(next_token.token, tokens)) {
+		else if (TokenKind_is_one_of(next_token.kind, tokens)) {
 			Lexer_next(self->lexer);
 			ParseNode* expr = Parser_parse_unary_expression(self);
 			if (expr == NULL)
@@ -574,14 +565,14 @@ Array* Parser_parse_arguments(Parser* self)
 	while (true) {
 		// Next ")" or ",".
 		Token next_token = Lexer_peek(self->lexer);
-		if (next_token.type == Operator && String_equals_c(next_token.token, ")")) {
+		if (next_token.type == Operator && next_token.kind == K_RPAREN) {
 			Lexer_next(self->lexer);
 			break;
 			}
 		if (need_comma) {
 			if (next_token.type == EndOfText)
 				Error("Unterminated argument list starting %s.", where(start_token.line_number, self->filename));
-			if (next_token.type != Operator || !String_equals_c(next_token.token, ","))
+			if (next_token.type != Operator || next_token.kind != K_COMMA)
 				Error("Comma expected between arguments %s.", where(next_token.line_number, self->filename));
 			Lexer_next(self->lexer);
 			need_comma = false;
@@ -611,7 +602,7 @@ ParseNode* Parser_parse_dot_call(Parser* self, ParseNode* receiver)
 
 	// Parse the arguments (if there are any).
 	Token next_token = Lexer_peek(self->lexer);
-	if (next_token.type == Operator && String_equals_c(next_token.token, "(")) {
+	if (next_token.type == Operator && next_token.kind == K_LPAREN) {
 		Array* args = Parser_parse_arguments(self);
 		call->arguments = args;
 		}
@@ -640,7 +631,7 @@ ParseNode* Parser_parse_index_call(Parser* self, ParseNode* receiver)
 
 	// Finish.
 	Token token = Lexer_next(self->lexer);
-	if (token.type != Operator || !String_equals_c(token.token, "]"))
+	if (token.type != Operator || token.kind != K_RBRACKET)
 		Error("Expected \"]\" %s.", where(token.line_number, self->filename));
 	return (ParseNode*) call;
 }
@@ -658,14 +649,14 @@ ParseNode* Parser_parse_postfix_expression(Parser* self)
 			break;
 
 		// Method call.
-		if (String_equals_c(next_token.token, "."))
+		if (next_token.kind == K_DOT)
 			expr = Parser_parse_dot_call(self, expr);
 
 		// Function call.
-		else if (String_equals_c(next_token.token, "("))
+		else if (next_token.kind == K_LPAREN)
 			expr = Parser_parse_fn_call(self, expr);
 
-		else if (String_equals_c(next_token.token, "["))
+		else if (next_token.kind == K_LBRACKET)
 			expr = Parser_parse_index_call(self, expr);
 
 		else
@@ -697,35 +688,35 @@ ParseNode* Parser_parse_primary_expression(Parser* self)
 
 	else if (next_token.type == Identifier) {
 		Lexer_next(self->lexer);
-		if (String_equals_c(next_token.token, "true"))
+		if (next_token.kind == K_TRUE)
 			return (ParseNode*) new_BooleanLiteral(true);
-		else if (String_equals_c(next_token.token, "false"))
+		else if (next_token.kind == K_FALSE)
 			return (ParseNode*) new_BooleanLiteral(false);
-		else if (String_equals_c(next_token.token, "nil"))
+		else if (next_token.kind == K_NIL)
 			return new_NilLiteral();
-		else if (String_equals_c(next_token.token, "self"))
+		else if (next_token.kind == K_SELF)
 			return (ParseNode*) new_SelfExpr();
-		else if (String_equals_c(next_token.token, "super"))
+		else if (next_token.kind == K_SUPER)
 			return Parser_parse_super_call(self);
-		else if (String_equals_c(next_token.token, "$")) {
+		else if (next_token.kind == K_DOLLAR) {
 			Token next_token = Lexer_peek(self->lexer);
-			if (next_token.type == Operator && String_equals_c(next_token.token, "("))
+			if (next_token.type == Operator && next_token.kind == K_LPAREN)
 				return Parser_parse_capture(self);
 			}
 		return (ParseNode*) new_Variable(next_token.token, next_token.line_number, self->filename);
 		}
 
 	else if (next_token.type == Operator) {
-		if (String_equals_c(next_token.token, "["))
+		if (next_token.kind == K_LBRACKET)
 			return Parser_parse_array_literal(self);
-		else if (String_equals_c(next_token.token, "{"))
+		else if (next_token.kind == K_LBRACE)
 			return Parser_parse_dict_literal(self);
-		else if (String_equals_c(next_token.token, "(")) {
+		else if (next_token.kind == K_LPAREN) {
 			int start_line_number = next_token.line_number;
 			Lexer_next(self->lexer);
 			ParseNode* expr = Parser_parse_expression(self);
 			next_token = Lexer_next(self->lexer);
-			if (next_token.type != Operator || !String_equals_c(next_token.token, ")"))
+			if (next_token.type != Operator || next_token.kind != K_RPAREN)
 				Error("Missing \")\" %s.", where(start_line_number, self->filename));
 			return expr;
 			}
@@ -948,11 +939,11 @@ ParseNode* Parser_parse_array_literal(Parser* self)
 	while (true) {
 		Token next_token = Lexer_peek(self->lexer);
 		if (next_token.type == Operator) {
-			if (String_equals_c(next_token.token, "]")) {
+			if (next_token.kind == K_RBRACKET) {
 				Lexer_next(self->lexer);
 				break;
 				}
-			else if (String_equals_c(next_token.token, ",")) {
+			else if (next_token.kind == K_COMMA) {
 				Lexer_next(self->lexer);
 				continue;
 				}
@@ -977,9 +968,9 @@ ParseNode* Parser_parse_dict_literal(Parser* self)
 		// Name.
 		Token token = Lexer_next(self->lexer);
 		if (token.type == Operator) {
-			if (String_equals_c(token.token, "}"))
+			if (token.kind == K_RBRACE)
 				break;
-			else if (String_equals_c(token.token, ","))
+			else if (token.kind == K_COMMA)
 				continue;
 			else
 				Error("Expected name in Dict literal %s.", where(token.line_number, self->filename));
@@ -990,7 +981,7 @@ ParseNode* Parser_parse_dict_literal(Parser* self)
 
 		// ":" or "=".
 		token = Lexer_next(self->lexer);
-		if (token.type != Operator || !(String_equals_c(token.token, ":") || String_equals_c(token.token, "=")))
+		if (token.type != Operator || !(token.kind == K_COLON || token.kind == K_ASSIGN))
 			Error("Expected \":\" or \"=\" in Dict literal %s.", where(token.line_number, self->filename));
 
 		// Value.
@@ -1012,7 +1003,7 @@ ParseNode* Parser_parse_super_call(Parser* self)
 
 	// "."
 	Token token = Lexer_next(self->lexer);
-	if (token.type != Operator && !String_equals_c(token.token, "."))
+	if (token.type != Operator && token.kind != K_DOT)
 		Error("Expected \".\" in \"super\" call %s.", where(token.line_number, self->filename));
 
 	// Name.
@@ -1022,7 +1013,7 @@ ParseNode* Parser_parse_super_call(Parser* self)
 
 	// Arguments.
 	token = Lexer_peek(self->lexer);
-	if (token.type == Operator && String_equals_c(token.token, "(")) {
+	if (token.type == Operator && token.kind == K_LPAREN) {
 		Array* arguments = Parser_parse_arguments(self);
 		call->arguments = arguments;
 		}
@@ -1037,9 +1028,9 @@ String* Parser_parse_fn_name(Parser* self)
 	String* name = token.token;
 	bool can_be_set = true;
 	if (token.type == Operator) {
-		if (String_equals_c(token.token, "[")) {
+		if (token.kind == K_LBRACKET) {
 			token = Lexer_next(self->lexer);
-			if (token.type != Operator || !String_equals_c(token.token, "]"))
+			if (token.type != Operator || token.kind != K_RBRACKET)
 				Error("Expected \"[]\" as a function name, not just \"[\", %s.", where(token.line_number, self->filename));
 			name = new_c_static_String("[]");
 			}
@@ -1052,7 +1043,7 @@ String* Parser_parse_fn_name(Parser* self)
 	// Add "="?
 	if (can_be_set) {
 		token = Lexer_peek(self->lexer);
-		if (token.type == Operator && String_equals_c(token.token, "=")) {
+		if (token.type == Operator && token.kind == K_ASSIGN) {
 			name = String_add(name, token.token);
 			Lexer_next(self->lexer);
 			}
@@ -1067,16 +1058,16 @@ Array* Parser_parse_names_list(Parser* self, const char* type)
 	Array* arguments = new_Array();
 
 	Token token = Lexer_peek(self->lexer);
-	if (token.type != Operator || !String_equals_c(token.token, "("))
+	if (token.type != Operator || token.kind != K_LPAREN)
 		return arguments;
 
 	Lexer_next(self->lexer); 	// Consume "(".
 	while (true) {
 		token = Lexer_next(self->lexer);
 		if (token.type == Operator) {
-			if (String_equals_c(token.token, ")"))
+			if (token.kind == K_RPAREN)
 				break;
-			else if (String_equals_c(token.token, ","))
+			else if (token.kind == K_COMMA)
 				continue;
 			}
 		if (token.type != Identifier)
@@ -56,7 +56,7 @@ Object* Path_init(Object* super, Object** args)
 Object* Path_string(Object* super, Object** args)
 {
 	Path* self = (Path*) super;
-	return (Object*) new_static_String(self->path, strlen(self->path));
+	return (Object*) new_c_static_String(self->path);
 }
 
 Object* Path_basename(Object* super, Object** args)
@@ -67,7 +67,7 @@ Object* Path_basename(Object* super, Object** args)
 		start_char += 1;
 	else
 		start_char = self->path;
-	return (Object*) new_static_String(start_char, strlen(start_char));
+	return (Object*) new_c_static_String(start_char);
 }
 
 Object* Path_dirname(Object* super, Object** args)
@@ -178,29 +178,24 @@ Object* Path_can_execute(Object* super, Object** args)
 	return Path_can_access(super, X_OK);
 }
 
+Object* Path_equals(Object* super, Object** args)
+{
+	if (args[0] == NULL || args[0]->class_ != &Path_class)
+		return &false_obj;
+	return make_bool(strcmp(((Path*) super)->path, ((Path*) args[0])->path) == 0);
+}
+
+Object* Path_not_equals(Object* super, Object** args)
+{
+	return make_bool(!IS_TRUTHY(Path_equals(super, args)));
+}
+
 
 void Path_init_class()
 {
 	init_static_class(Path);
 
-	static const BuiltinMethodSpec builtin_methods[] = {
-		{ "init", 2, Path_init },
-		{ "string", 0, Path_string },
-		{ "basename", 0, Path_basename },
-		{ "base-name", 0, Path_basename },
-		{ "dirname", 0, Path_dirname },
-		{ "dir-name", 0, Path_dirname },
-		{ "exists", 0, Path_exists },
-		{ "is-file", 0, Path_is_file },
-		{ "is-dir", 0, Path_is_dir },
-		{ "is-symlink", 0, Path_is_symlink },
-		{ "size", 0, Path_size },
-		{ "can-read", 0, Path_can_read },
-		{ "can-write", 0, Path_can_write },
-		{ "can-execute", 0, Path_can_execute },
-		{ NULL },
-		};
-	Class_add_builtin_methods(&Path_class, builtin_methods);
+	set_builtin_methods(Path);
 }
 
 
@@ -3,6 +3,7 @@
 #include "Object.h"
 #include "String.h"
 #include "ByteArray.h"
+#include "StringBuilder.h"
 #include "Int.h"
 #include "Memory.h"
 #include "Error.h"
@@ -69,7 +70,10 @@ Object* Pipe_capture(Pipe* self, bool as_string, size_t size_limit)
 			Error("Capturing too much output in Pipe.capture().");
 		}
 
-	return (as_string ? (Object*) ByteArray_as_string(bytes) : (Object*) bytes);
+	// Nothing else has the ByteArray, so a String can take over its bytes.
+	if (as_string)
+		return (Object*) new_static_String((char*) bytes->array, bytes->size);
+	return (Object*) bytes;
 }
 
 
@@ -126,8 +130,13 @@ Object* Pipe_write(Object* super, Object** args)
 		p = (const uint8_t*) str->str;
 		bytes_left = str->size;
 		}
+	else if (args[0]->class_ == &StringBuilder_class) {
+		StringBuilder* builder = (StringBuilder*) args[0];
+		p = (const uint8_t*) builder->buffer;
+		bytes_left = builder->size;
+		}
 	else
-		Error("Pipe.write() requires a ByteArray or a String.");
+		Error("Pipe.write() requires a ByteArray, a String, or a StringBuilder.");
 
 	size_t total_bytes_written = 0;
 	while (bytes_left > 0) {
@@ -149,16 +158,7 @@ Object* Pipe_write(Object* super, Object** args)
 void Pipe_init_class()
 {
 	init_static_class(Pipe);
-	static const BuiltinMethodSpec builtin_methods[] = {
-		{ "init", 0, Pipe_init },
-		{ "close", 0, Pipe_close_builtin },
-		{ "capture", 0, Pipe_capture_builtin },
-		{ "read-all", 0, Pipe_capture_builtin },
-		{ "read", 1, Pipe_read },
-		{ "write", 1, Pipe_write },
-		{ NULL },
-		};
-	Class_add_builtin_methods(&Pipe_class, builtin_methods);
+	set_builtin_methods(Pipe);
 }
 
 
@@ -175,19 +175,16 @@ Object* RegexMatch_remainder(Object* super, Object** args)
 	RegexMatch* self = (RegexMatch*) super;
 
 	regoff_t remainder_start = self->matches[0].rm_eo;
-	return (Object*) new_static_String(self->str->str + remainder_start, self->str->size - remainder_start);
+	String* remainder = new_static_String(self->str->str + remainder_start, self->str->size - remainder_start);
+	remainder->is_c_str = self->str->is_c_str;
+	return (Object*) remainder;
 }
 
 
 void Regex_init_class()
 {
 	init_static_class(Regex);
-	static const BuiltinMethodSpec builtin_methods[] = {
-		{ "init", 2, Regex_init },
-		{ "match", 2, Regex_match },
-		{ NULL },
-		};
-	Class_add_builtin_methods(&Regex_class, builtin_methods);
+	set_builtin_methods(Regex);
 
 	String_init_static_c(&extended_syntax, "extended-syntax");
 	String_init_static_c(&case_insensitive, "case-insensitive");
@@ -196,12 +193,7 @@ void Regex_init_class()
 	String_init_static_c(&not_eol, "not-eol");
 
 	init_static_class(RegexMatch);
-	static const BuiltinMethodSpec match_methods[] = {
-		{ "[]", 1, RegexMatch_at },
-		{ "remainder", 0, RegexMatch_remainder },
-		{ NULL },
-		};
-	Class_add_builtin_methods(&RegexMatch_class, match_methods);
+	set_builtin_methods(RegexMatch);
 }
 
 
@@ -0,0 +1,96 @@
+#include "Region.h"
+#include "Memory.h"
+#include <stdint.h>
+#include <pthread.h>
+
+typedef struct RegionChunk {
+	struct RegionChunk* next;
+	struct RegionChunk* prev_live;
+	struct RegionChunk* next_live;
+	} RegionChunk;
+
+#define region_alignment (2 * sizeof(void*))
+#define align(size) (((size) + region_alignment - 1) & ~(region_alignment - 1))
+static const size_t chunk_header_size = align(sizeof(RegionChunk));
+static const size_t chunk_size = 64 * 1024;
+
+_Thread_local Region compiler_region;
+
+// Chunks are ordinary collectable memory, but while a Region is handing them
+// out they're all on this list, so the collector can't take them.  (Regions
+// themselves can be thread-local, where the collector might not look.)
+static RegionChunk* live_chunks = NULL;
+static pthread_mutex_t live_chunks_lock = PTHREAD_MUTEX_INITIALIZER;
+
+
+static void unlink_live_chunk(RegionChunk* chunk)
+{
+	// Call with "live_chunks_lock" locked.
+	if (chunk->prev_live)
+		chunk->prev_live->next_live = chunk->next_live;
+	else
+		live_chunks = chunk->next_live;
+	if (chunk->next_live)
+		chunk->next_live->prev_live = chunk->prev_live;
+	chunk->prev_live = chunk->next_live = NULL;
+}
+
+
+void* Region_alloc(Region* self, size_t size)
+{
+	size = align(size);
+	if (size > (size_t) (self->end - self->next)) {
+		// Start a new chunk.  Whatever's left in the old one is wasted.
+		size_t data_size = chunk_size - chunk_header_size;
+		if (size > data_size)
+			data_size = size;
+		RegionChunk* chunk = (RegionChunk*) alloc_mem(chunk_header_size + data_size);
+		pthread_mutex_lock(&live_chunks_lock);
+		chunk->next_live = live_chunks;
+		if (live_chunks)
+			live_chunks->prev_live = chunk;
+		live_chunks = chunk;
+		pthread_mutex_unlock(&live_chunks_lock);
+		chunk->next = self->chunks;
+		self->chunks = chunk;
+		self->next = (char*) chunk + chunk_header_size;
+		self->end = self->next + data_size;
+		}
+
+	void* result = self->next;
+	self->next += size;
+	return result;
+}
+
+
+void Region_let_go(Region* self)
+{
+	// Unlink the chunks from each other too, so each one lives only as long as
+	// something points into it.
+	pthread_mutex_lock(&live_chunks_lock);
+	RegionChunk* chunk = self->chunks;
+	while (chunk) {
+		RegionChunk* next_chunk = chunk->next;
+		unlink_live_chunk(chunk);
+		chunk->next = NULL;
+		chunk = next_chunk;
+		}
+	pthread_mutex_unlock(&live_chunks_lock);
+	self->chunks = NULL;
+	self->next = self->end = NULL;
+}
+
+
+void Region_adopt(Region* self, Region* other)
+{
+	// Other's chunks go at the end of our list, so we keep allocating from our
+	// current chunk.
+	if (other->chunks) {
+		RegionChunk** tail = &self->chunks;
+		while (*tail)
+			tail = &(*tail)->next;
+		*tail = other->chunks;
+		}
+	other->chunks = NULL;
+	other->next = other->end = NULL;
+}
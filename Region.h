@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stddef.h>
+
+// A Region hands out memory by just bumping a pointer.  The garbage collector
+// scans a Region's memory (so things in it can point to collected objects),
+// but doesn't collect it until the Region lets go of it.
+
+struct RegionChunk;
+
+typedef struct Region {
+	struct RegionChunk* chunks;
+	char* next;
+	char* end;
+	} Region;
+
+extern void* Region_alloc(Region* self, size_t size);
+	// The memory is cleared.
+extern void Region_let_go(Region* self);
+	// Hands the memory over to the garbage collector, which frees each part of
+	// it once nothing points into it.  The Region is left empty.
+extern void Region_adopt(Region* self, Region* other);
+	// Takes over all of "other"'s memory, leaving "other" empty.
+
+extern _Thread_local Region compiler_region;
+	// Parse trees, MethodBuilders, and Environments, which are garbage once
+	// everything that needs them is compiled.  Each thread that parses gets its
+	// own.
+
+#define alloc_compiler_obj(Type) ((Type*) Region_alloc(&compiler_region, sizeof(Type)))
+
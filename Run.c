@@ -17,6 +17,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include <errno.h>
+#include <time.h>
 
 declare_string(capture_string, "capture");
 declare_string(wait_string, "wait");
@@ -35,9 +36,11 @@ typedef struct RunResult {
 	int return_code;
 	Pipe* capture_pipe;
 	Object* captured_output;
+	struct timespec start_time;
+	long elapsed_usecs; 	// Wall-clock time until the process was seen to exit.
 	} RunResult;
 Class RunResult_class;
-static RunResult* new_RunResult(pid_t pid, Pipe* capture_pipe);
+static RunResult* new_RunResult(pid_t pid, Pipe* capture_pipe, struct timespec* start_time);
 Object* RunResult_wait(Object* super, Object** args);
 void RunResult_capture(RunResult* self);
 
@@ -132,6 +135,8 @@ Object* Run(Object* self, Object** args)
 		}
 
 	// Fork.
+	struct timespec start_time;
+	clock_gettime(CLOCK_MONOTONIC, &start_time);
 	pid_t pid = fork();
 	if (pid < 0)
 		Error("run(): fork() failed (%s).", strerror(errno));
@@ -190,7 +195,7 @@ Object* Run(Object* self, Object** args)
 			}
 
 		// Wait for child to exit.
-		RunResult* run_result = new_RunResult(pid, stdout_pipe);
+		RunResult* run_result = new_RunResult(pid, stdout_pipe, &start_time);
 		if (wait) {
 			if (capture)
 				RunResult_capture(run_result);
@@ -203,16 +208,29 @@ Object* Run(Object* self, Object** args)
 }
 
 
-static RunResult* new_RunResult(pid_t pid, Pipe* capture_pipe)
+static RunResult* new_RunResult(pid_t pid, Pipe* capture_pipe, struct timespec* start_time)
 {
 	RunResult* self = alloc_obj(RunResult);
 	self->class_ = &RunResult_class;
 	self->pid = pid;
 	self->capture_pipe = capture_pipe;
+	self->start_time = *start_time;
 	return self;
 }
 
 
+static void RunResult_finish(RunResult* self, int status)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	self->elapsed_usecs =
+		(now.tv_sec - self->start_time.tv_sec) * 1000000L +
+		(now.tv_nsec - self->start_time.tv_nsec) / 1000;
+	self->return_code = WEXITSTATUS(status);
+	self->done = true;
+}
+
+
 Object* RunResult_return_code(Object* super, Object** args)
 {
 	RunResult_wait(super, NULL);
@@ -238,12 +256,17 @@ Object* RunResult_wait(Object* super, Object** args)
 	if (!self->done) {
 		int status = 0;
 		waitpid(self->pid, &status, 0);
-		self->return_code = WEXITSTATUS(status);
-		self->done = true;
+		RunResult_finish(self, status);
 		}
 	return (Object*) self;
 }
 
+Object* RunResult_elapsed_usecs(Object* super, Object** args)
+{
+	RunResult_wait(super, NULL);
+	return (Object*) new_Int(((RunResult*) super)->elapsed_usecs);
+}
+
 Object* RunResult_is_done(Object* super, Object** args)
 {
 	RunResult* self = (RunResult*) super;
@@ -254,8 +277,7 @@ Object* RunResult_is_done(Object* super, Object** args)
 	pid_t result = waitpid(self->pid, &status, WNOHANG);
 	if (result == 0)
 		return &false_obj;
-	self->return_code = WEXITSTATUS(status);
-	self->done = true;
+	RunResult_finish(self, status);
 	return &true_obj;
 }
 
@@ -272,15 +294,7 @@ void RunResult_capture(RunResult* self)
 void Run_init()
 {
 	init_static_class(RunResult);
-	static const BuiltinMethodSpec run_result_methods[] = {
-		{ "return-code", 0, RunResult_return_code },
-		{ "ok", 0, RunResult_ok },
-		{ "output", 0, RunResult_output },
-		{ "wait", 0, RunResult_wait },
-		{ "is-done", 0, RunResult_is_done },
-		{ NULL },
-		};
-	Class_add_builtin_methods(&RunResult_class, run_result_methods);
+	set_builtin_methods(RunResult);
 }
 
 
@@ -298,8 +312,9 @@ char** build_environ(Dict* env)
 			break;
 		if (kv.value == NULL)
 			continue;
+		String* name = String_enforce(kv.key, "run(): \"env\" keys must be strings.");
 		String* value = String_enforce(kv.value, "run(): \"env\" values must be strings.");
-		String* entry = String_add(kv.key, String_add(&equals_string, value));
+		String* entry = String_add(name, String_add(&equals_string, value));
 		*next_env_entry++ = (char*) String_c_str(entry);
 		}
 	// Null-terminate the list.
@@ -6,9 +6,12 @@
 #include "Environment.h"
 #include "ByteCode.h"
 #include "Array.h"
+#include "Dict.h"
+#include "String.h"
 #include "Object.h"
 #include "Pipe.h"
 #include "Run.h"
+#include "Region.h"
 #include "Memory.h"
 #include "Error.h"
 
@@ -49,9 +52,9 @@ RunCommand* Parser_parse_run_command(Parser* self)
 			Array_append(arguments, (Object*) Parser_parse_string_literal(self));
 		else if (token.type == Identifier || token.type == RawStringLiteral || token.type == IntLiteral) {
 			Lexer_next(self->lexer);
-			if (token.type == Identifier && String_equals_c(token.token, "$")) {
+			if (token.type == Identifier && token.kind == K_DOLLAR) {
 				Token next_token = Lexer_peek(self->lexer);
-				if (next_token.type == Operator && String_equals_c(next_token.token, "(")) {
+				if (next_token.type == Operator && next_token.kind == K_LPAREN) {
 					Array_append(arguments, (Object*) Parser_parse_capture(self));
 					continue;
 					}
@@ -60,10 +63,10 @@ RunCommand* Parser_parse_run_command(Parser* self)
 			}
 
 		else if (token.type == Operator) {
-			static const char* terminating_operators[] = { "&&", "||", "|", ")", NULL };
+			static const TokenKind terminating_operators[] = { K_AND, K_OR, K_BIT_OR, K_RPAREN, K_NONE };
 
 			// Coalesce "-" or "+" with the next identifier, "-", or "+".
-			if (String_equals_c(token.token, "-") || String_equals_c(token.token, "+")) {
+			if (token.kind == K_MINUS || token.kind == K_PLUS) {
 				String* arg = token.token;
 				Lexer_next(self->lexer);
 				while (true) {
@@ -74,7 +77,7 @@ RunCommand* Parser_parse_run_command(Parser* self)
 						break;
 						}
 					else if (token.type == Operator) {
-						if (String_equals_c(token.token, "-") || String_equals_c(token.token, "+")) {
+						if (token.kind == K_MINUS || token.kind == K_PLUS) {
 							arg = String_add(arg, token.token);
 							Lexer_next(self->lexer);
 							}
@@ -88,17 +91,18 @@ RunCommand* Parser_parse_run_command(Parser* self)
 				}
 
 			// Expression inside "{}" or "()".
-			else if (String_equals_c(token.token, "{") || String_equals_c(token.token, "(")) {
+			else if (token.kind == K_LBRACE || token.kind == K_LPAREN) {
 				char start_char = token.token->str[0];
 				Lexer_next(self->lexer);
 				Array_append(arguments, (Object*) Parser_parse_expression(self));
 				const char* end_char = (start_char == '{' ? "}" : ")");
+				TokenKind end_kind = (start_char == '{' ? K_RBRACE : K_RPAREN);
 				token = Lexer_next(self->lexer);
-				if (token.type != Operator || !String_equals_c(token.token, end_char))
+				if (token.type != Operator || token.kind != end_kind)
 					Error("Missing \"%s\" %s.", end_char, where(token.line_number, self->filename));
 				}
 
-			else if (String_is_one_of(token.token, terminating_operators)) {
+			else if (TokenKind_is_one_of(token.kind, terminating_operators)) {
 				// These end a command.
 				break;
 				}
@@ -123,7 +127,7 @@ ParseNode* Parser_parse_run_pipeline(Parser* self)
 	RunPipeline* pipeline = NULL;
 	while (true) {
 		Token token = Lexer_peek(self->lexer);
-		if (token.type != Operator || !String_equals_c(token.token, "|"))
+		if (token.type != Operator || token.kind != K_BIT_OR)
 			break;
 		Lexer_next(self->lexer);
 
@@ -153,7 +157,7 @@ ParseNode* Parser_parse_run_statement(Parser* self)
 		if (token.type != Operator)
 			break;
 
-		if (String_equals_c(token.token, "&&") || String_equals_c(token.token, "||")) {
+		if (token.kind == K_AND || token.kind == K_OR) {
 			int line_number = Lexer_next(self->lexer).line_number;
 			ParseNode* command_2 = Parser_parse_run_pipeline(self);
 			if (command_2 == NULL)
@@ -191,7 +195,7 @@ ParseNode* Parser_parse_capture(Parser* self)
 	if (pipeline == NULL)
 		Error("Expected a command or pipeline in \"$()\" %s.", where(token.line_number, self->filename));
 	token = Lexer_next(self->lexer);
-	if (token.type != Operator || !String_equals_c(token.token, ")"))
+	if (token.type != Operator || token.kind != K_RPAREN)
 		Error("Missing \")\" at end of \"$()\" %s.", where(token.line_number, self->filename));
 
 	return (ParseNode*) new_RunCapture(pipeline);
@@ -297,7 +301,7 @@ void RunCommand_resolve_names(ParseNode* super, MethodBuilder* method)
 
 RunCommand* new_RunCommand(Array* arguments)
 {
-	RunCommand* run_statement = alloc_obj(RunCommand);
+	RunCommand* run_statement = alloc_compiler_obj(RunCommand);
 	run_statement->parse_node.type = PN_RunCommand;
 	run_statement->parse_node.emit = RunCommand_emit;
 	run_statement->parse_node.resolve_names = RunCommand_resolve_names;
@@ -372,7 +376,7 @@ void RunPipeline_resolve_names(ParseNode* super, MethodBuilder* method)
 
 RunPipeline* new_RunPipeline()
 {
-	RunPipeline* self = alloc_obj(RunPipeline);
+	RunPipeline* self = alloc_compiler_obj(RunPipeline);
 	self->parse_node.type = PN_RunPipeline;
 	self->parse_node.emit = RunPipeline_emit;
 	self->parse_node.resolve_names = RunPipeline_resolve_names;
@@ -443,7 +447,7 @@ RunCapture* new_RunCapture(ParseNode* pipeline)
 	else
 		((RunCommand*) pipeline)->capture = true;
 
-	RunCapture* self = alloc_obj(RunCapture);
+	RunCapture* self = alloc_compiler_obj(RunCapture);
 	self->parse_node.emit = RunCapture_emit;
 	self->parse_node.resolve_names = RunCapture_resolve_names;
 	self->pipeline = pipeline;
@@ -451,10 +455,9 @@ RunCapture* new_RunCapture(ParseNode* pipeline)
 }
 
 
-#include "BuiltinMethod.h"
 #include <unistd.h>
 
-static Object* run_fail(Object* self, Object** args)
+Object* RunStatement_fail(Object* self, Object** args)
 {
 	exit(1);
 	return NULL;
@@ -462,7 +465,10 @@ static Object* run_fail(Object* self, Object** args)
 
 static ParseNode* add_fail_check(ParseNode* run_expr)
 {
-	ParseNode* fail_fn = (ParseNode*) new_GlobalExpr((Object*) new_BuiltinMethod(0, &run_fail));
+	// RunStatement_fail() is added to the global environment (under a name that
+	// scripts can't use), so the bytecode cache can find it.
+	declare_static_string(run_fail_string, "-run-fail-");
+	ParseNode* fail_fn = (ParseNode*) new_GlobalExpr(Dict_at(global_environment.dict, &run_fail_string));
 	if (run_expr->type == PN_RunCommand || run_expr->type == PN_RunPipeline)
 		run_expr = (ParseNode*) new_CallExpr(run_expr, &ok_string);
 	return
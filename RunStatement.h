@@ -2,9 +2,9 @@
 
 struct ParseNode;
 struct Parser;
+struct Object;
 
 
 extern struct ParseNode* Parser_parse_run_statement(struct Parser* self);
 extern struct ParseNode* Parser_parse_capture(struct Parser* self);
-
-
+extern struct Object* RunStatement_fail(struct Object* self, struct Object** args);
@@ -0,0 +1,161 @@
+#include "Search.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Short needles are found by using memchr() to jump to each occurrence of the
+// first byte, and checking the last byte before comparing the rest.  Longer
+// needles use the Two-Way algorithm (Crochemore & Perrin), which is linear
+// even for needles like "aaaaaab" in a haystack of "a"s.
+
+#define max_short_needle 8
+
+static size_t maximal_suffix(const uint8_t* needle, size_t needle_size, size_t* period_out, bool reversed)
+{
+	// Returns the start of the maximal suffix minus one (which can be
+	// SIZE_MAX, ie. -1), and its period.
+	size_t suffix = SIZE_MAX;
+	size_t j = 0, k = 1, period = 1;
+	while (j + k < needle_size) {
+		uint8_t a = needle[suffix + k];
+		uint8_t b = needle[j + k];
+		if (a == b) {
+			if (k == period) {
+				j += period;
+				k = 1;
+				}
+			else
+				k += 1;
+			}
+		else if (reversed ? a < b : a > b) {
+			j += k;
+			k = 1;
+			period = j - suffix;
+			}
+		else {
+			suffix = j++;
+			k = period = 1;
+			}
+		}
+	*period_out = period;
+	return suffix;
+}
+
+static const char* two_way(const uint8_t* haystack, const uint8_t* haystack_end, const uint8_t* needle, size_t needle_size)
+{
+	// Bad-character shifts: for each byte, how far from the end of the needle
+	// it last appears (plus one), or zero if it doesn't.
+	size_t shift[256];
+	memset(shift, 0, sizeof(shift));
+	for (size_t i = 0; i < needle_size; ++i)
+		shift[needle[i]] = i + 1;
+
+	// Critical factorization.
+	size_t period, reversed_period;
+	size_t split = maximal_suffix(needle, needle_size, &period, false);
+	size_t reversed_split = maximal_suffix(needle, needle_size, &reversed_period, true);
+	if (reversed_split + 1 > split + 1) {
+		split = reversed_split;
+		period = reversed_period;
+		}
+
+	// If the needle is periodic, matched bytes can be remembered across shifts.
+	size_t memory_after_shift;
+	if (memcmp(needle, needle + period, split + 1) != 0) {
+		size_t left = split + 1, right = needle_size - split - 1;
+		period = (left > right ? left : right) + 1;
+		memory_after_shift = 0;
+		}
+	else
+		memory_after_shift = needle_size - period;
+	size_t memory = 0;
+
+	const uint8_t* h = haystack;
+	while (haystack_end - h >= (ptrdiff_t) needle_size) {
+		// Check the last byte first.
+		size_t last_shift = shift[h[needle_size - 1]];
+		if (last_shift == 0) {
+			h += needle_size;
+			memory = 0;
+			continue;
+			}
+		size_t k = needle_size - last_shift;
+		if (k != 0) {
+			if (k < memory)
+				k = memory;
+			h += k;
+			memory = 0;
+			continue;
+			}
+
+		// Compare the right half.
+		k = (split + 1 > memory ? split + 1 : memory);
+		while (k < needle_size && needle[k] == h[k])
+			k += 1;
+		if (k < needle_size) {
+			h += k - split;
+			memory = 0;
+			continue;
+			}
+
+		// Compare the left half.
+		k = split + 1;
+		while (k > memory && needle[k - 1] == h[k - 1])
+			k -= 1;
+		if (k <= memory)
+			return (const char*) h;
+		h += period;
+		memory = memory_after_shift;
+		}
+
+	return NULL;
+}
+
+
+const char* find_bytes(const char* haystack, size_t haystack_size, const char* needle, size_t needle_size)
+{
+	if (needle_size == 0)
+		return haystack;
+	if (needle_size > haystack_size)
+		return NULL;
+	if (needle_size == 1)
+		return (const char*) memchr(haystack, needle[0], haystack_size);
+
+	const char* last_start = haystack + haystack_size - needle_size;
+	const char* p = haystack;
+	if (needle_size <= max_short_needle) {
+		char first = needle[0], last = needle[needle_size - 1];
+		while (p <= last_start) {
+			p = (const char*) memchr(p, first, last_start - p + 1);
+			if (p == NULL)
+				return NULL;
+			if (p[needle_size - 1] == last && memcmp(p + 1, needle + 1, needle_size - 2) == 0)
+				return p;
+			p += 1;
+			}
+		return NULL;
+		}
+
+	// Skip to the first possible start before setting up Two-Way.
+	p = (const char*) memchr(haystack, needle[0], last_start - haystack + 1);
+	if (p == NULL)
+		return NULL;
+	return two_way((const uint8_t*) p, (const uint8_t*) haystack + haystack_size, (const uint8_t*) needle, needle_size);
+}
+
+
+const char* rfind_bytes(const char* haystack, size_t haystack_size, const char* needle, size_t needle_size)
+{
+	if (needle_size == 0)
+		return haystack + haystack_size;
+	if (needle_size > haystack_size)
+		return NULL;
+
+	char first = needle[0], last = needle[needle_size - 1];
+	for (size_t start = haystack_size - needle_size + 1; start-- > 0; ) {
+		const char* p = haystack + start;
+		if (p[needle_size - 1] == last && p[0] == first && memcmp(p, needle, needle_size) == 0)
+			return p;
+		}
+	return NULL;
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <stddef.h>
+
+// Substring search, like memmem() (which isn't part of POSIX).  Both return
+// NULL if the needle isn't found; an empty needle is found at the start (or
+// the end, for rfind_bytes()).
+
+extern const char* find_bytes(const char* haystack, size_t haystack_size, const char* needle, size_t needle_size);
+extern const char* rfind_bytes(const char* haystack, size_t haystack_size, const char* needle, size_t needle_size);
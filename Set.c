@@ -0,0 +1,192 @@
+#include "Set.h"
+#include "Dict.h"
+#include "Array.h"
+#include "String.h"
+#include "Class.h"
+#include "Object.h"
+#include "Boolean.h"
+#include "Int.h"
+#include "ByteCode.h"
+#include "Memory.h"
+
+Class Set_class;
+static Class SetIterator_class;
+
+
+Set* new_Set()
+{
+	Set* self = alloc_obj(Set);
+	Set_init(self);
+	return self;
+}
+
+
+void Set_init(Set* self)
+{
+	self->class_ = &Set_class;
+	self->items = new_Dict();
+}
+
+
+void Set_add(Set* self, Object* item)
+{
+	Dict_set_at_object(self->items, item, item);
+}
+
+bool Set_remove(Set* self, Object* item)
+{
+	return Dict_remove_object(self->items, item, NULL);
+}
+
+bool Set_contains(Set* self, Object* item)
+{
+	return Dict_at_object(self->items, item) != NULL;
+}
+
+
+static void Set_add_all(Set* self, Object* items)
+{
+	// "items" can be a Set, Array, or Dict (whose keys are used), or anything
+	// else with an "iterator".
+	if (items == NULL)
+		return;
+	if (items->class_ == &Array_class) {
+		Array* array = (Array*) items;
+		for (int i = 0; i < array->size; ++i)
+			Set_add(self, array->items[i]);
+		}
+	else if (items->class_ == &Set_class || items->class_ == &Dict_class) {
+		Dict* dict = (items->class_ == &Set_class ? ((Set*) items)->items : (Dict*) items);
+		DictIterator* it = new_DictIterator(dict);
+		while (true) {
+			DictIteratorResult kv = DictIterator_next(it);
+			if (kv.key == NULL)
+				break;
+			Set_add(self, kv.key);
+			}
+		}
+	else {
+		Object* it = call_object(items, &iterator_string, NULL);
+		while (true) {
+			Object* item = call_object(it, &next_string, NULL);
+			if (item == NULL)
+				break;
+			Set_add(self, item);
+			}
+		}
+}
+
+static Set* Set_enforce_set(Object* object)
+{
+	// Lets the set operations take any collection Set_add_all() can.
+	if (object && object->class_ == &Set_class)
+		return (Set*) object;
+	Set* set = new_Set();
+	Set_add_all(set, object);
+	return set;
+}
+
+
+Object* Set_init_builtin(Object* super, Object** args)
+{
+	Set* self = (Set*) super;
+	Set_init(self);
+	Set_add_all(self, args[0]);
+	return super;
+}
+
+Object* Set_add_builtin(Object* super, Object** args)
+{
+	Set_add((Set*) super, args[0]);
+	return super;
+}
+
+Object* Set_remove_builtin(Object* super, Object** args)
+{
+	Set_remove((Set*) super, args[0]);
+	return super;
+}
+
+Object* Set_contains_builtin(Object* super, Object** args)
+{
+	return make_bool(Set_contains((Set*) super, args[0]));
+}
+
+Object* Set_size_builtin(Object* super, Object** args)
+{
+	return (Object*) new_Int(((Set*) super)->items->size);
+}
+
+Object* Set_is_empty_builtin(Object* super, Object** args)
+{
+	return make_bool(((Set*) super)->items->size == 0);
+}
+
+Object* Set_union_builtin(Object* super, Object** args)
+{
+	Set* result = new_Set();
+	Set_add_all(result, super);
+	Set_add_all(result, args[0]);
+	return (Object*) result;
+}
+
+Object* Set_intersection_builtin(Object* super, Object** args)
+{
+	Set* other = Set_enforce_set(args[0]);
+	Set* result = new_Set();
+	DictIterator* it = new_DictIterator(((Set*) super)->items);
+	while (true) {
+		DictIteratorResult kv = DictIterator_next(it);
+		if (kv.key == NULL)
+			break;
+		if (Set_contains(other, kv.key))
+			Set_add(result, kv.key);
+		}
+	return (Object*) result;
+}
+
+Object* Set_difference_builtin(Object* super, Object** args)
+{
+	Set* other = Set_enforce_set(args[0]);
+	Set* result = new_Set();
+	DictIterator* it = new_DictIterator(((Set*) super)->items);
+	while (true) {
+		DictIteratorResult kv = DictIterator_next(it);
+		if (kv.key == NULL)
+			break;
+		if (!Set_contains(other, kv.key))
+			Set_add(result, kv.key);
+		}
+	return (Object*) result;
+}
+
+
+typedef struct SetIterator {
+	Class* class_;
+	DictIterator* dict_iterator;
+	} SetIterator;
+
+Object* Set_iterator_builtin(Object* super, Object** args)
+{
+	SetIterator* iterator = alloc_obj(SetIterator);
+	iterator->class_ = &SetIterator_class;
+	iterator->dict_iterator = new_DictIterator(((Set*) super)->items);
+	return (Object*) iterator;
+}
+
+Object* SetIterator_next(Object* super, Object** args)
+{
+	// Items come out in the order they were added.
+	return DictIterator_next(((SetIterator*) super)->dict_iterator).key;
+}
+
+
+void Set_init_class()
+{
+	init_static_class(Set);
+	set_builtin_methods(Set);
+
+	init_static_class(SetIterator);
+	set_builtin_methods(SetIterator);
+}
+
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdbool.h>
+
+struct Class;
+struct Object;
+struct Dict;
+
+
+typedef struct Set {
+	struct Class* class_;
+	struct Dict* items;
+		// The items are both the keys and the values, so they follow the same
+		// hashing rules as Dict keys.
+	} Set;
+
+extern Set* new_Set();
+extern void Set_init(Set* self);
+extern void Set_add(Set* self, struct Object* item);
+extern bool Set_remove(Set* self, struct Object* item);
+extern bool Set_contains(Set* self, struct Object* item);
+
+extern struct Class Set_class;
+extern void Set_init_class();
+
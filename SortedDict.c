@@ -0,0 +1,489 @@
+#include "SortedDict.h"
+#include "Dict.h"
+#include "Array.h"
+#include "String.h"
+#include "Class.h"
+#include "Object.h"
+#include "Boolean.h"
+#include "Int.h"
+#include "Float.h"
+#include "ByteCode.h"
+#include "Memory.h"
+#include "Error.h"
+#include <string.h>
+
+typedef struct SortedDictNode {
+	uint32_t left, right;
+	uint32_t level;
+	struct Object* key;
+	struct Object* value;
+	} SortedDictNode;
+
+// Index zero represents a null "pointer"; its level is zero.  Real nodes start
+// at level one.  Removed nodes are kept on "free_list", linked by "right".
+
+#define Node(index) (self->nodes[index])
+#define min_capacity 16
+
+Class SortedDict_class;
+static Class SortedDictIterator_class;
+
+
+declare_static_string(less_than_string, "<");
+
+static bool generic_less(Object* a, Object* b)
+{
+	Object* items[] = { b };
+	Array args_array = { &Array_class, 1, 1, items };
+	return IS_TRUTHY(call_object(a, &less_than_string, &args_array));
+}
+
+static int compare_keys(Object* a, Object* b)
+{
+	if (a == NULL || b == NULL)
+		Error("SortedDict keys can't be nil.");
+	Class* a_class = a->class_;
+	Class* b_class = b->class_;
+	if (a_class == &String_class && b_class == &String_class)
+		return String_cmp((String*) a, (String*) b);
+	if (a_class == &Int_class && b_class == &Int_class) {
+		int a_value = Int_value(a), b_value = Int_value(b);
+		return (a_value < b_value ? -1 : a_value > b_value ? 1 : 0);
+		}
+	bool a_is_number = (a_class == &Int_class || a_class == &Float_class);
+	bool b_is_number = (b_class == &Int_class || b_class == &Float_class);
+	if (a_is_number && b_is_number) {
+		double a_value = (a_class == &Int_class ? Int_value(a) : Float_value(a));
+		double b_value = (b_class == &Int_class ? Int_value(b) : Float_value(b));
+		return (a_value < b_value ? -1 : a_value > b_value ? 1 : 0);
+		}
+	if (generic_less(a, b))
+		return -1;
+	if (generic_less(b, a))
+		return 1;
+	return 0;
+}
+
+
+static uint32_t SortedDict_skew(SortedDict* self, uint32_t node)
+{
+	if (node == 0)
+		return 0;
+	uint32_t left = Node(node).left;
+	if (left != 0 && Node(left).level == Node(node).level) {
+		// Swap the pointers of the horizontal left links.
+		Node(node).left = Node(left).right;
+		Node(left).right = node;
+		return left;
+		}
+	return node;
+}
+
+
+static uint32_t SortedDict_split(SortedDict* self, uint32_t node)
+{
+	if (node == 0)
+		return 0;
+	uint32_t right = Node(node).right;
+	if (right == 0 || Node(right).right == 0)
+		return node;
+	if (Node(node).level == Node(Node(right).right).level) {
+		// We have two horizontal right links.  Elevate the middle node as the root
+		// of this subtree.
+		Node(node).right = Node(right).left;
+		Node(right).left = node;
+		Node(right).level += 1;
+		return right;
+		}
+	return node;
+}
+
+
+static uint32_t SortedDict_create_node(SortedDict* self, Object* key, Object* value)
+{
+	uint32_t node = self->free_list;
+	if (node)
+		self->free_list = Node(node).right;
+	else {
+		if (self->num_nodes + 1 >= self->capacity) {
+			uint32_t new_capacity = (self->capacity ? self->capacity * 2 : min_capacity);
+			SortedDictNode* new_nodes = (SortedDictNode*) alloc_mem(new_capacity * sizeof(SortedDictNode));
+			if (self->nodes)
+				memcpy(new_nodes, self->nodes, (self->num_nodes + 1) * sizeof(SortedDictNode));
+			self->nodes = new_nodes;
+			self->capacity = new_capacity;
+			}
+		node = ++self->num_nodes;
+		}
+
+	SortedDictNode* t = &Node(node);
+	t->left = t->right = 0;
+	t->level = 1;
+	t->key = key;
+	t->value = value;
+	self->size += 1;
+	return node;
+}
+
+
+static void SortedDict_free_node(SortedDict* self, uint32_t node)
+{
+	SortedDictNode* t = &Node(node);
+	t->key = t->value = NULL;
+	t->left = 0;
+	t->right = self->free_list;
+	self->free_list = node;
+	self->size -= 1;
+}
+
+
+static uint32_t SortedDict_insert(SortedDict* self, Object* key, Object* value, uint32_t node)
+{
+	if (node == 0)
+		return SortedDict_create_node(self, key, value);
+	// Note: "self->nodes" can be reallocated by SortedDict_insert(), so don't
+	// hold on to node pointers across it.
+	int cmp = compare_keys(key, Node(node).key);
+	if (cmp < 0) {
+		uint32_t new_left = SortedDict_insert(self, key, value, Node(node).left);
+		Node(node).left = new_left;
+		}
+	else if (cmp > 0) {
+		uint32_t new_right = SortedDict_insert(self, key, value, Node(node).right);
+		Node(node).right = new_right;
+		}
+	else {
+		Node(node).value = value;
+		return node;
+		}
+
+	node = SortedDict_skew(self, node);
+	node = SortedDict_split(self, node);
+	return node;
+}
+
+
+static uint32_t SortedDict_delete(SortedDict* self, Object* key, uint32_t node, bool* found)
+{
+	if (node == 0)
+		return 0;
+
+	int cmp = compare_keys(key, Node(node).key);
+	if (cmp < 0)
+		Node(node).left = SortedDict_delete(self, key, Node(node).left, found);
+	else if (cmp > 0)
+		Node(node).right = SortedDict_delete(self, key, Node(node).right, found);
+	else {
+		*found = true;
+		if (Node(node).left == 0 && Node(node).right == 0) {
+			SortedDict_free_node(self, node);
+			return 0;
+			}
+		// Replace this node's entry with its successor's (or predecessor's), and
+		// delete that one instead.
+		uint32_t other;
+		if (Node(node).left == 0) {
+			for (other = Node(node).right; Node(other).left; other = Node(other).left)
+				;
+			Object* other_key = Node(other).key;
+			Object* other_value = Node(other).value;
+			Node(node).right = SortedDict_delete(self, other_key, Node(node).right, found);
+			Node(node).key = other_key;
+			Node(node).value = other_value;
+			}
+		else {
+			for (other = Node(node).left; Node(other).right; other = Node(other).right)
+				;
+			Object* other_key = Node(other).key;
+			Object* other_value = Node(other).value;
+			Node(node).left = SortedDict_delete(self, other_key, Node(node).left, found);
+			Node(node).key = other_key;
+			Node(node).value = other_value;
+			}
+		}
+
+	// Rebalance: decrease the level if needed, then skew and split the path.
+	uint32_t left_level = Node(Node(node).left).level;
+	uint32_t right_level = Node(Node(node).right).level;
+	uint32_t should_be = (left_level < right_level ? left_level : right_level) + 1;
+	if (should_be < Node(node).level) {
+		Node(node).level = should_be;
+		uint32_t right = Node(node).right;
+		if (right && should_be < Node(right).level)
+			Node(right).level = should_be;
+		}
+	node = SortedDict_skew(self, node);
+	Node(node).right = SortedDict_skew(self, Node(node).right);
+	uint32_t right = Node(node).right;
+	if (right)
+		Node(right).right = SortedDict_skew(self, Node(right).right);
+	node = SortedDict_split(self, node);
+	Node(node).right = SortedDict_split(self, Node(node).right);
+	return node;
+}
+
+
+SortedDict* new_SortedDict()
+{
+	SortedDict* self = alloc_obj(SortedDict);
+	SortedDict_init(self);
+	return self;
+}
+
+
+void SortedDict_init(SortedDict* self)
+{
+	// Node zero always exists, so "Node(0).level" can be read.
+	self->class_ = &SortedDict_class;
+	self->capacity = min_capacity;
+	self->nodes = (SortedDictNode*) alloc_mem(self->capacity * sizeof(SortedDictNode));
+	self->root = self->free_list = 0;
+	self->num_nodes = 0;
+	self->size = 0;
+}
+
+
+void SortedDict_set_at(SortedDict* self, Object* key, Object* value)
+{
+	if (key == NULL)
+		Error("SortedDict keys can't be nil.");
+	self->root = SortedDict_insert(self, key, value, self->root);
+}
+
+
+static uint32_t SortedDict_find(SortedDict* self, Object* key)
+{
+	uint32_t node = self->root;
+	while (node != 0) {
+		int cmp = compare_keys(key, Node(node).key);
+		if (cmp < 0)
+			node = Node(node).left;
+		else if (cmp > 0)
+			node = Node(node).right;
+		else
+			return node;
+		}
+	return 0;
+}
+
+
+Object* SortedDict_at(SortedDict* self, Object* key)
+{
+	if (key == NULL)
+		return NULL;
+	return Node(SortedDict_find(self, key)).value;
+}
+
+
+bool SortedDict_remove(SortedDict* self, Object* key)
+{
+	if (key == NULL)
+		return false;
+	bool found = false;
+	self->root = SortedDict_delete(self, key, self->root, &found);
+	return found;
+}
+
+
+static uint32_t SortedDict_floor(SortedDict* self, Object* key)
+{
+	// The node with the greatest key <= "key", or zero.
+	uint32_t node = self->root, result = 0;
+	while (node != 0) {
+		int cmp = compare_keys(key, Node(node).key);
+		if (cmp == 0)
+			return node;
+		else if (cmp < 0)
+			node = Node(node).left;
+		else {
+			result = node;
+			node = Node(node).right;
+			}
+		}
+	return result;
+}
+
+
+static uint32_t SortedDict_ceiling(SortedDict* self, Object* key)
+{
+	// The node with the least key >= "key", or zero.
+	uint32_t node = self->root, result = 0;
+	while (node != 0) {
+		int cmp = compare_keys(key, Node(node).key);
+		if (cmp == 0)
+			return node;
+		else if (cmp > 0)
+			node = Node(node).right;
+		else {
+			result = node;
+			node = Node(node).left;
+			}
+		}
+	return result;
+}
+
+
+static Object* SortedDict_entry(SortedDict* self, uint32_t node)
+{
+	if (node == 0)
+		return NULL;
+	return new_DictIteratorKeyValue(Node(node).key, Node(node).value);
+}
+
+
+
+// An AA tree's height is at most 2 * log2(n + 1), so this is plenty.
+#define max_depth 64
+
+typedef struct SortedDictIterator {
+	Class* class_;
+	SortedDict* dict;
+	Object* end; 	// Stop before this key; NULL for no limit.
+	int depth;
+	uint32_t stack[max_depth];
+	} SortedDictIterator;
+
+static SortedDictIterator* new_SortedDictIterator(SortedDict* dict, Object* start, Object* end)
+{
+	// Iterates over the keys >= "start" (or all of them if it's NULL), and
+	// < "end".
+	SortedDictIterator* self = alloc_obj(SortedDictIterator);
+	self->class_ = &SortedDictIterator_class;
+	self->dict = dict;
+	self->end = end;
+	self->depth = 0;
+
+	// Push the path to the first node, skipping the subtrees that are all
+	// before "start".
+	uint32_t node = dict->root;
+	while (node != 0) {
+		SortedDictNode* t = &dict->nodes[node];
+		if (start && compare_keys(t->key, start) < 0)
+			node = t->right;
+		else {
+			self->stack[self->depth++] = node;
+			node = t->left;
+			}
+		}
+	return self;
+}
+
+Object* SortedDictIterator_next(Object* super, Object** args)
+{
+	SortedDictIterator* self = (SortedDictIterator*) super;
+	if (self->depth == 0)
+		return NULL;
+	SortedDictNode* nodes = self->dict->nodes;
+	uint32_t node = self->stack[--self->depth];
+	if (self->end && compare_keys(nodes[node].key, self->end) >= 0) {
+		self->depth = 0;
+		return NULL;
+		}
+	Object* result = new_DictIteratorKeyValue(nodes[node].key, nodes[node].value);
+
+	// Go forward.
+	for (uint32_t next = nodes[node].right; next != 0; next = nodes[next].left)
+		self->stack[self->depth++] = next;
+
+	return result;
+}
+
+Object* SortedDictIterator_iterator(Object* super, Object** args)
+{
+	// So "range()" can be used directly in a "for" statement.
+	return super;
+}
+
+
+Object* SortedDict_init_builtin(Object* super, Object** args)
+{
+	SortedDict_init((SortedDict*) super);
+	return super;
+}
+
+Object* SortedDict_at_builtin(Object* super, Object** args)
+{
+	return SortedDict_at((SortedDict*) super, args[0]);
+}
+
+Object* SortedDict_set_at_builtin(Object* super, Object** args)
+{
+	SortedDict_set_at((SortedDict*) super, args[0], args[1]);
+	return args[1];
+}
+
+Object* SortedDict_contains_builtin(Object* super, Object** args)
+{
+	return make_bool(args[0] && SortedDict_find((SortedDict*) super, args[0]) != 0);
+}
+
+Object* SortedDict_remove_builtin(Object* super, Object** args)
+{
+	SortedDict_remove((SortedDict*) super, args[0]);
+	return super;
+}
+
+Object* SortedDict_size_builtin(Object* super, Object** args)
+{
+	return (Object*) new_Int(((SortedDict*) super)->size);
+}
+
+Object* SortedDict_is_empty_builtin(Object* super, Object** args)
+{
+	return make_bool(((SortedDict*) super)->size == 0);
+}
+
+Object* SortedDict_first_builtin(Object* super, Object** args)
+{
+	SortedDict* self = (SortedDict*) super;
+	uint32_t node = self->root;
+	while (node && Node(node).left)
+		node = Node(node).left;
+	return SortedDict_entry(self, node);
+}
+
+Object* SortedDict_last_builtin(Object* super, Object** args)
+{
+	SortedDict* self = (SortedDict*) super;
+	uint32_t node = self->root;
+	while (node && Node(node).right)
+		node = Node(node).right;
+	return SortedDict_entry(self, node);
+}
+
+Object* SortedDict_floor_builtin(Object* super, Object** args)
+{
+	SortedDict* self = (SortedDict*) super;
+	if (args[0] == NULL)
+		return NULL;
+	return SortedDict_entry(self, SortedDict_floor(self, args[0]));
+}
+
+Object* SortedDict_ceiling_builtin(Object* super, Object** args)
+{
+	SortedDict* self = (SortedDict*) super;
+	if (args[0] == NULL)
+		return NULL;
+	return SortedDict_entry(self, SortedDict_ceiling(self, args[0]));
+}
+
+Object* SortedDict_range_builtin(Object* super, Object** args)
+{
+	return (Object*) new_SortedDictIterator((SortedDict*) super, args[0], args[1]);
+}
+
+Object* SortedDict_iterator_builtin(Object* super, Object** args)
+{
+	return (Object*) new_SortedDictIterator((SortedDict*) super, NULL, NULL);
+}
+
+
+void SortedDict_init_class()
+{
+	init_static_class(SortedDict);
+	set_builtin_methods(SortedDict);
+
+	init_static_class(SortedDictIterator);
+	set_builtin_methods(SortedDictIterator);
+}
+
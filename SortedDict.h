@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+struct Class;
+struct Object;
+struct SortedDictNode;
+
+// A Dict kept sorted by key, as an AA tree.  Keys are compared directly if
+// they're all Strings or all numbers, otherwise with their "<" methods.
+
+typedef struct SortedDict {
+	struct Class* class_;
+	struct SortedDictNode* nodes;
+	uint32_t root, free_list;
+	uint32_t num_nodes, capacity;
+	int size;
+	} SortedDict;
+
+extern SortedDict* new_SortedDict();
+extern void SortedDict_init(SortedDict* self);
+extern void SortedDict_set_at(SortedDict* self, struct Object* key, struct Object* value);
+extern struct Object* SortedDict_at(SortedDict* self, struct Object* key);
+extern bool SortedDict_remove(SortedDict* self, struct Object* key);
+
+extern struct Class SortedDict_class;
+extern void SortedDict_init_class();
+
@@ -8,12 +8,15 @@
 #include "ByteArray.h"
 #include "Memory.h"
 #include "UTF8.h"
+#include "Search.h"
 #include "Error.h"
 #include <string.h>
 #include <stdbool.h>
 
+#define char_offset_interval 64
+
 Class String_class;
-String empty_string = { &String_class, NULL, 0 };
+String empty_string = { &String_class, "", 0, 0, true };
 declare_string(iterator_string, "iterator");
 declare_string(next_string, "next");
 
@@ -91,6 +94,66 @@ int String_cmp(String* self, String* other)
 	return cmp;
 }
 
+uint32_t String_hash(String* self)
+{
+	// Strings don't change, so the hash is computed just once.
+	if (self->hash == 0)
+		self->hash = String_hash_c(self->str, self->size);
+	return self->hash;
+}
+
+uint32_t String_hash_c(const char* str, size_t size)
+{
+	// FNV-1a.  Zero means "not computed yet" in a String, so it's never a hash.
+	uint32_t hash = 2166136261U;
+	const uint8_t* p = (const uint8_t*) str;
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= p[i];
+		hash *= 16777619U;
+		}
+	if (hash == 0)
+		hash = 1;
+	return hash;
+}
+
+int String_num_chars(String* self)
+{
+	// Like the hash, the count is computed just once.  A valid UTF-8 String is
+	// all ASCII exactly when it has as many characters as bytes.
+	if (!self->chars_counted) {
+		int num_chars = chars_in_utf8(self->str, self->size);
+		if (num_chars < 0)
+			return -1;
+		self->num_chars = num_chars;
+		self->chars_counted = true;
+		}
+	return self->num_chars;
+}
+
+int String_char_offset(String* self, int char_index)
+{
+	int num_chars = String_num_chars(self);
+	if (num_chars == self->size)
+		return char_index;
+	if (num_chars <= char_offset_interval)
+		return bytes_in_n_characters(self->str, char_index);
+
+	if (self->char_offsets == NULL) {
+		int num_offsets = num_chars / char_offset_interval + 1;
+		uint32_t* offsets = (uint32_t*) alloc_mem_no_pointers(num_offsets * sizeof(uint32_t));
+		const char* p = self->str;
+		offsets[0] = 0;
+		for (int i = 1; i < num_offsets; ++i) {
+			p += bytes_in_n_characters(p, char_offset_interval);
+			offsets[i] = p - self->str;
+			}
+		self->char_offsets = offsets;
+		}
+
+	int offset = self->char_offsets[char_index / char_offset_interval];
+	return offset + bytes_in_n_characters(self->str + offset, char_index % char_offset_interval);
+}
+
 bool String_starts_with(String* self, String* other)
 {
 	if (self->size < other->size)
@@ -108,11 +171,16 @@ bool String_ends_with(String* self, String* other)
 
 const char* String_c_str(struct String* self)
 {
-	// Useful for debugging.
+	if (self->is_c_str)
+		return self->str;
 
+	// Strings don't change, so the copy can stand in for the original bytes,
+	// and later calls won't need to copy again.
 	char* str = (char*) alloc_mem_no_pointers(self->size + 1);
 	memcpy(str, self->str, self->size);
 	str[self->size] = 0;
+	self->str = str;
+	self->is_c_str = true;
 	return str;
 }
 
@@ -139,10 +207,12 @@ String* String_add(String* self, String* other)
 	result->class_ = &String_class;
 	int total_size = self->size + other->size;
 	result->size = total_size;
-	char* result_str = alloc_mem_no_pointers(total_size);
+	char* result_str = alloc_mem_no_pointers(total_size + 1);
 	memcpy(result_str, self->str, self->size);
 	memcpy(result_str + self->size, other->str, other->size);
+	result_str[total_size] = 0;
 	result->str = result_str;
+	result->is_c_str = true;
 	return result;
 }
 
@@ -152,8 +222,14 @@ void String_init(String* self, const char* str, size_t size)
 	self->class_ = &String_class;
 
 	self->size = size;
-	self->str = alloc_mem_no_pointers(size);
-	memcpy((char*) self->str, str, size);
+	char* new_str = alloc_mem_no_pointers(size + 1);
+	memcpy(new_str, str, size);
+	new_str[size] = 0;
+	self->str = new_str;
+	self->hash = 0;
+	self->is_c_str = true;
+	self->chars_counted = false;
+	self->char_offsets = NULL;
 }
 
 
@@ -162,6 +238,10 @@ void String_init_static(String* self, const char* str, size_t size)
 	self->class_ = &String_class;
 	self->str = str;
 	self->size = size;
+	self->hash = 0;
+	self->is_c_str = false;
+	self->chars_counted = false;
+	self->char_offsets = NULL;
 }
 
 void String_init_static_c(String* self, const char* str)
@@ -169,10 +249,14 @@ void String_init_static_c(String* self, const char* str)
 	self->class_ = &String_class;
 	self->str = str;
 	self->size = strlen(str);
+	self->hash = 0;
+	self->is_c_str = true;
+	self->chars_counted = false;
+	self->char_offsets = NULL;
 }
 
 
-static Object* String_add_builtin(Object* self, Object** args)
+Object* String_add_builtin(Object* self, Object** args)
 {
 	if (args[0] == NULL || args[0]->class_ != &String_class)
 		Error("Attempt to add a non-string to a string.");
@@ -180,41 +264,41 @@ static Object* String_add_builtin(Object* self, Object** args)
 	return (Object*) String_add((String*) self, (String*) args[0]);
 }
 
-static Object* String_equals_builtin(Object* self, Object** args)
+Object* String_equals_builtin(Object* self, Object** args)
 {
 	if (args[0] == NULL || args[0]->class_ != &String_class)
 		return &false_obj;
 	return make_bool(String_equals((String*) self, (String*) args[0]));
 }
 
-static Object* String_not_equals_builtin(Object* self, Object** args)
+Object* String_not_equals_builtin(Object* self, Object** args)
 {
 	if (args[0] == NULL || args[0]->class_ != &String_class)
 		return &false_obj;
 	return make_bool(!String_equals((String*) self, (String*) args[0]));
 }
 
-static Object* String_less_than_builtin(Object* self, Object** args)
+Object* String_less_than_builtin(Object* self, Object** args)
 {
 	return make_bool(String_cmp((String*) self, String_enforce(args[0], "<")) < 0);
 }
 
-static Object* String_greater_than_builtin(Object* self, Object** args)
+Object* String_greater_than_builtin(Object* self, Object** args)
 {
 	return make_bool(String_cmp((String*) self, String_enforce(args[0], ">")) > 0);
 }
 
-static Object* String_less_than_equals_builtin(Object* self, Object** args)
+Object* String_less_than_equals_builtin(Object* self, Object** args)
 {
 	return make_bool(String_cmp((String*) self, String_enforce(args[0], "<=")) <= 0);
 }
 
-static Object* String_greater_than_equals_builtin(Object* self, Object** args)
+Object* String_greater_than_equals_builtin(Object* self, Object** args)
 {
 	return make_bool(String_cmp((String*) self, String_enforce(args[0], ">=")) >= 0);
 }
 
-static Object* String_strip_builtin(Object* super, Object** args)
+Object* String_strip_builtin(Object* super, Object** args)
 {
 	String* self = (String*) super;
 	const char* new_start = self->str;
@@ -241,7 +325,7 @@ static Object* String_strip_builtin(Object* super, Object** args)
 	return (Object*) new_static_String(new_start, new_end - new_start);
 }
 
-static Object* String_lstrip_builtin(Object* super, Object** args)
+Object* String_lstrip_builtin(Object* super, Object** args)
 {
 	String* self = (String*) super;
 	const char* new_start = self->str;
@@ -258,7 +342,7 @@ static Object* String_lstrip_builtin(Object* super, Object** args)
 	return (Object*) new_static_String(new_start, end - new_start);
 }
 
-static Object* String_rstrip_builtin(Object* super, Object** args)
+Object* String_rstrip_builtin(Object* super, Object** args)
 {
 	String* self = (String*) super;
 	const char* start = self->str;
@@ -275,7 +359,7 @@ static Object* String_rstrip_builtin(Object* super, Object** args)
 	return (Object*) new_static_String(start, new_end - start);
 }
 
-static Object* String_split_builtin(Object* super, Object** args)
+Object* String_split_builtin(Object* super, Object** args)
 {
 	String* self = (String*) super;
 	Array* result = new_Array();
@@ -311,19 +395,10 @@ static Object* String_split_builtin(Object* super, Object** args)
 	else {
 		String* delimiter = String_enforce(args[0], "String.split");
 		size_t delimiter_size = delimiter->size;
+		if (delimiter_size == 0)
+			Error("Empty delimiter in String.split.");
 		while (true) {
-			// Find the start of the delimiter.
-			// (We'd use memmem() but it's not part of POSIX.)
-			const char* delimiter_start = NULL;
-			const char* search_p = p;
-			while (search_p < end) {
-				if (memcmp(search_p, delimiter->str, delimiter_size) == 0) {
-					delimiter_start = search_p;
-					break;
-					}
-				search_p += 1;
-				}
-
+			const char* delimiter_start = find_bytes(p, end - p, delimiter->str, delimiter_size);
 			if (delimiter_start) {
 				Array_append(result, (Object*) new_static_String(p, delimiter_start - p));
 				p = delimiter_start + delimiter_size;
@@ -350,34 +425,85 @@ Object* String_ends_with_builtin(Object* super, Object** args)
 	return make_bool(String_ends_with((String*) super, other));
 }
 
-int index_of(const char* haystack, size_t haystack_size, const char* needle, size_t needle_size)
+Object* String_contains_builtin(Object* super, Object** args)
+{
+	String* self = (String*) super;
+	String* other = String_enforce(args[0], "String.contains");
+	return make_bool(find_bytes(self->str, self->size, other->str, other->size) != NULL);
+}
+
+static Object* String_char_index(String* self, const char* p, const char* name)
 {
-	// memmem() is not part of Posix, so we have to do it ourself.
-	const char* haystack_end = haystack + haystack_size - needle_size + 1;
-	const char* needle_end = needle + needle_size;
-	for (const char* haystack_p = haystack; haystack_p < haystack_end; ++haystack_p) {
-		const char* needle_p = needle;
-		const char* cur_haystack_p = haystack_p;
-		for (; needle_p < needle_end; ++needle_p, ++cur_haystack_p) {
-			if (*cur_haystack_p != *needle_p)
-				break;
+	// Returns the character index (as an Int) of the byte at "p".
+	int num_chars = String_num_chars(self);
+	if (num_chars < 0)
+		Error("Invalid UTF-8 (in %s).", name);
+	if (num_chars == self->size)
+		return (Object*) new_Int(p - self->str);
+	return (Object*) new_Int(chars_in_utf8(self->str, p - self->str));
+}
+
+Object* String_find_builtin(Object* super, Object** args)
+{
+	String* self = (String*) super;
+	String* other = String_enforce(args[0], "String.find");
+	size_t start_offset = 0;
+	if (args[1]) {
+		int num_chars = String_num_chars(self);
+		if (num_chars < 0)
+			Error("Invalid UTF-8 (in String.find).");
+		int start = Int_enforce(args[1], "String.find");
+		if (start < 0) {
+			start += num_chars;
+			if (start < 0)
+				start = 0;
 			}
-		if (needle_p == needle_end)
-			return haystack_p - haystack;
+		if (start > num_chars)
+			return NULL;
+		start_offset = String_char_offset(self, start);
 		}
-	return -1;
+	const char* found = find_bytes(self->str + start_offset, self->size - start_offset, other->str, other->size);
+	return (found ? String_char_index(self, found, "String.find") : NULL);
 }
 
-Object* String_contains_builtin(Object* super, Object** args)
+Object* String_rfind_builtin(Object* super, Object** args)
 {
 	String* self = (String*) super;
-	String* other = String_enforce(args[0], "String.contains");
-	return make_bool(index_of(self->str, self->size, other->str, other->size) >= 0);
+	String* other = String_enforce(args[0], "String.rfind");
+	const char* found = rfind_bytes(self->str, self->size, other->str, other->size);
+	return (found ? String_char_index(self, found, "String.rfind") : NULL);
+}
+
+Object* String_count_builtin(Object* super, Object** args)
+{
+	String* self = (String*) super;
+	String* other = String_enforce(args[0], "String.count");
+	if (other->size == 0) {
+		int num_chars = String_num_chars(self);
+		if (num_chars < 0)
+			Error("Invalid UTF-8 (in String.count).");
+		return (Object*) new_Int(num_chars + 1);
+		}
+	int count = 0;
+	const char* p = self->str;
+	const char* end = p + self->size;
+	while (true) {
+		p = find_bytes(p, end - p, other->str, other->size);
+		if (p == NULL)
+			break;
+		count += 1;
+		p += other->size;
+		}
+	return (Object*) new_Int(count);
 }
 
 Object* String_is_valid_builtin(Object* super, Object** args)
 {
 	String* self = (String*) super;
+	if (self->chars_counted && self->num_chars == self->size) {
+		// All ASCII.
+		return &true_obj;
+		}
 	return make_bool(is_valid_utf8(self->str, self->size));
 }
 
@@ -391,15 +517,14 @@ Object* String_bytes(Object* super, Object** args)
 {
 	String* self = (String*) super;
 	ByteArray* byte_array = new_ByteArray();
-	byte_array->size = byte_array->capacity = self->size;
-	byte_array->array = (uint8_t*) self->str;
+	ByteArray_append_bytes(byte_array, (uint8_t*) self->str, self->size);
 	return (Object*) byte_array;
 }
 
 Object* String_size(Object* super, Object** args)
 {
 	String* self = (String*) super;
-	int num_chars = chars_in_utf8(self->str, self->size);
+	int num_chars = String_num_chars(self);
 	if (num_chars < 0)
 		Error("Invalid UTF-8 (in string.size).");
 	return (Object*) new_Int(num_chars);
@@ -414,7 +539,7 @@ Object* String_is_empty(Object* super, Object** args)
 Object* String_slice(Object* super, Object** args)
 {
 	String* self = (String*) super;
-	int num_chars = chars_in_utf8(self->str, self->size);
+	int num_chars = String_num_chars(self);
 	if (num_chars < 0)
 		Error("Invalid UTF-8 (in string.slice())");
 	int start = args[0] ? Int_enforce(args[0], "String.slice") : 0;
@@ -435,8 +560,12 @@ Object* String_slice(Object* super, Object** args)
 
 	String* result = alloc_obj(String);
 	result->class_ = &String_class;
-	result->str = self->str + bytes_in_n_characters(self->str, start);
-	result->size = bytes_in_n_characters(result->str, end - start);
+	int start_offset = String_char_offset(self, start);
+	result->str = self->str + start_offset;
+	result->size = String_char_offset(self, end) - start_offset;
+	result->chars_counted = true;
+	result->num_chars = end - start;
+	result->is_c_str = (self->is_c_str && result->str + result->size == self->str + self->size);
 	return (Object*) result;
 }
 
@@ -445,13 +574,15 @@ Object* String_replace(Object* super, Object** args)
 	String* self = (String*) super;
 	String* old_str = String_enforce(args[0], "String.replace");
 	String* new_str = String_enforce(args[1], "String.replace");
+	if (old_str->size == 0)
+		return super;
 	Array* segments = NULL;
 	const char* remainder = self->str;
 	size_t remainder_size = self->size;
 	while (true) {
 		// Where is the old string?
-		int index = index_of(remainder, remainder_size, old_str->str, old_str->size);
-		if (index < 0) {
+		const char* found = find_bytes(remainder, remainder_size, old_str->str, old_str->size);
+		if (found == NULL) {
 			// No old string.
 			if (segments && remainder_size > 0) {
 				// Add in the last segment.
@@ -463,6 +594,7 @@ Object* String_replace(Object* super, Object** args)
 		// Add the bit leading up to the old string.
 		if (segments == NULL)
 			segments = new_Array();
+		size_t index = found - remainder;
 		if (index > 0)
 			Array_append(segments, (Object*) new_static_String(remainder, index));
 
@@ -483,35 +615,7 @@ void String_init_class()
 {
 	init_static_class(String);
 
-	static const BuiltinMethodSpec specs[] = {
-		{ "+", 1, String_add_builtin, },
-		{ "string", 0, Object_identity },
-		{ "==", 1, String_equals_builtin },
-		{ "!=", 1, String_not_equals_builtin },
-		{ "<", 1, String_less_than_builtin },
-		{ ">", 1, String_greater_than_builtin },
-		{ "<=", 1, String_less_than_equals_builtin },
-		{ ">=", 1, String_greater_than_equals_builtin },
-		{ "strip", 0, String_strip_builtin },
-		{ "lstrip", 0, String_lstrip_builtin },
-		{ "rstrip", 0, String_rstrip_builtin },
-		{ "trim", 0, String_strip_builtin },
-		{ "ltrim", 0, String_lstrip_builtin },
-		{ "rtrim", 0, String_rstrip_builtin },
-		{ "split", 1, String_split_builtin },
-		{ "starts-with", 1, String_starts_with_builtin },
-		{ "ends-with", 1, String_ends_with_builtin },
-		{ "contains", 1, String_contains_builtin },
-		{ "is-valid", 0, String_is_valid_builtin },
-		{ "decode-8859-1", 0, String_decode_8859_1_builtin },
-		{ "bytes", 0, String_bytes },
-		{ "size", 0, String_size },
-		{ "is-empty", 0, String_is_empty },
-		{ "slice", 2, String_slice },
-		{ "replace", 2, String_replace },
-		{ NULL, 0, NULL },
-		};
-	Class_add_builtin_methods(&String_class, specs);
+	set_builtin_methods(String);
 }
 
 
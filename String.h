@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <stdbool.h>
 
 struct Class;
@@ -10,6 +11,16 @@ typedef struct String {
 	struct Class* class_;
 	const char* str;
 	size_t size;
+	uint32_t hash; 	// Zero until String_hash() computes it.
+	bool is_c_str;
+		// "str[size]" is a NUL, so "str" can be used as a C string without
+		// copying it.
+	bool chars_counted;
+	int num_chars; 	// Valid once "chars_counted" is set.
+	uint32_t* char_offsets;
+		// For long non-ASCII Strings: the byte offset of every
+		// "char_offset_interval"th character, so slicing doesn't have to scan
+		// from the start.
 	} String;
 
 
@@ -21,9 +32,17 @@ extern bool String_equals(String* self, String* other);
 extern bool String_equals_c(String* self, const char* other);
 extern bool String_less_than(String* self, String* other);
 extern int String_cmp(String* self, String* other);
+extern uint32_t String_hash(String* self);
+extern int String_num_chars(String* self);
+	// Returns -1 if the String isn't valid UTF-8.
+extern int String_char_offset(String* self, int char_index);
+	// The byte offset of the character; "char_index" can be from zero to
+	// String_num_chars().
+extern uint32_t String_hash_c(const char* str, size_t size);
 extern bool String_starts_with(String* self, String* other);
 extern bool String_ends_with(String* self, String* other);
 extern const char* String_c_str(String* self);
+	// Only copies if the String isn't already NUL-terminated (eg. a slice).
 extern String* String_enforce(struct Object* object, const char* name);
 extern String* String_copy(String* other);
 
@@ -40,10 +59,10 @@ extern struct Class String_class;
 
 #define declare_static_string(name, value) 	\
 	static const char name##_chars[] = value; 	\
-	static String name = { &String_class, name##_chars, sizeof(value) - 1 };
+	static String name = { &String_class, name##_chars, sizeof(value) - 1, 0, true };
 #define declare_string(name, value) 	\
 	static const char name##_chars[] = value; 	\
-	String name = { &String_class, name##_chars, sizeof(value) - 1 };
+	String name = { &String_class, name##_chars, sizeof(value) - 1, 0, true };
 
 // A few widely-used strings.
 extern String empty_string;
@@ -0,0 +1,156 @@
+#include "StringBuilder.h"
+#include "String.h"
+#include "ByteArray.h"
+#include "Int.h"
+#include "Float.h"
+#include "Boolean.h"
+#include "ByteCode.h"
+#include "Memory.h"
+#include "Numbers.h"
+#include "Error.h"
+#include <string.h>
+
+#define min_capacity 64
+
+Class StringBuilder_class;
+
+declare_static_string(string_string, "string");
+
+
+StringBuilder* new_StringBuilder()
+{
+	StringBuilder* self = alloc_obj(StringBuilder);
+	self->class_ = &StringBuilder_class;
+	return self;
+}
+
+
+static void StringBuilder_reserve(StringBuilder* self, size_t needed_size)
+{
+	if (needed_size <= self->capacity)
+		return;
+	size_t new_capacity = (self->capacity < min_capacity ? min_capacity : self->capacity * 2);
+	while (new_capacity < needed_size)
+		new_capacity *= 2;
+	// Always a new buffer; the old one might belong to a String now.
+	char* new_buffer = (char*) alloc_mem_no_pointers(new_capacity);
+	if (self->size > 0)
+		memcpy(new_buffer, self->buffer, self->size);
+	self->buffer = new_buffer;
+	self->capacity = new_capacity;
+	self->handed_off = false;
+}
+
+
+void StringBuilder_append_bytes(StringBuilder* self, const char* bytes, size_t size)
+{
+	if (size == 0)
+		return;
+	StringBuilder_reserve(self, self->size + size);
+	memcpy(self->buffer + self->size, bytes, size);
+	self->size += size;
+}
+
+void StringBuilder_append_string(StringBuilder* self, String* str)
+{
+	StringBuilder_append_bytes(self, str->str, str->size);
+}
+
+
+void StringBuilder_append(StringBuilder* self, Object* value)
+{
+	Class* value_class = (value ? value->class_ : NULL);
+	if (value_class == &String_class)
+		StringBuilder_append_string(self, (String*) value);
+	else if (value_class == &Int_class || value_class == &Float_class) {
+		// Formatted straight into the buffer.
+		StringBuilder_reserve(self, self->size + max_formatted_float_size);
+		if (value_class == &Int_class)
+			self->size += format_int(Int_value(value), self->buffer + self->size);
+		else
+			self->size += format_float(Float_value(value), self->buffer + self->size);
+		}
+	else if (value_class == &ByteArray_class) {
+		ByteArray* byte_array = (ByteArray*) value;
+		StringBuilder_append_bytes(self, (const char*) byte_array->array, byte_array->size);
+		}
+	else if (value_class == &StringBuilder_class) {
+		StringBuilder* other = (StringBuilder*) value;
+		StringBuilder_append_bytes(self, other->buffer, other->size);
+		}
+	else {
+		String* str = (String*) call_object(value, &string_string, NULL);
+		StringBuilder_append_string(self, String_enforce((Object*) str, "StringBuilder.append"));
+		}
+}
+
+
+String* StringBuilder_string(StringBuilder* self)
+{
+	self->handed_off = true;
+	return new_static_String(self->buffer, self->size);
+}
+
+
+
+Object* StringBuilder_init_builtin(Object* super, Object** args)
+{
+	StringBuilder* self = (StringBuilder*) super;
+	self->class_ = &StringBuilder_class;
+	self->buffer = NULL;
+	self->size = self->capacity = 0;
+	self->handed_off = false;
+	if (args[0])
+		StringBuilder_append(self, args[0]);
+	return super;
+}
+
+Object* StringBuilder_append_builtin(Object* super, Object** args)
+{
+	StringBuilder_append((StringBuilder*) super, args[0]);
+	return super;
+}
+
+Object* StringBuilder_append_line_builtin(Object* super, Object** args)
+{
+	StringBuilder* self = (StringBuilder*) super;
+	if (args[0])
+		StringBuilder_append(self, args[0]);
+	StringBuilder_append_bytes(self, "\n", 1);
+	return super;
+}
+
+Object* StringBuilder_size_builtin(Object* super, Object** args)
+{
+	return (Object*) new_Int(((StringBuilder*) super)->size);
+}
+
+Object* StringBuilder_is_empty_builtin(Object* super, Object** args)
+{
+	return make_bool(((StringBuilder*) super)->size == 0);
+}
+
+Object* StringBuilder_string_builtin(Object* super, Object** args)
+{
+	return (Object*) StringBuilder_string((StringBuilder*) super);
+}
+
+Object* StringBuilder_clear_builtin(Object* super, Object** args)
+{
+	StringBuilder* self = (StringBuilder*) super;
+	if (self->handed_off) {
+		// Leave the buffer to the String.
+		self->buffer = NULL;
+		self->capacity = 0;
+		self->handed_off = false;
+		}
+	self->size = 0;
+	return super;
+}
+
+
+void StringBuilder_init_class()
+{
+	init_static_class(StringBuilder);
+	set_builtin_methods(StringBuilder);
+}
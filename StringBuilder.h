@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Class.h"
+#include "Object.h"
+#include <stddef.h>
+#include <stdbool.h>
+
+struct String;
+
+// Accumulates a String, growing its buffer geometrically, so building up a
+// String piece by piece takes linear time instead of quadratic.
+
+typedef struct StringBuilder {
+	Class* class_;
+	char* buffer;
+	size_t size, capacity;
+	bool handed_off;
+		// A String is using the buffer, so the bytes before "size" can't be
+		// changed.  Appending is still fine.
+	} StringBuilder;
+
+
+extern StringBuilder* new_StringBuilder();
+extern void StringBuilder_append_bytes(StringBuilder* self, const char* bytes, size_t size);
+extern void StringBuilder_append_string(StringBuilder* self, struct String* str);
+extern void StringBuilder_append(StringBuilder* self, Object* value);
+	// Strings, Ints, Floats, ByteArrays, and StringBuilders are appended
+	// directly; anything else is converted with its "string" method.
+extern struct String* StringBuilder_string(StringBuilder* self);
+	// Doesn't copy the bytes.
+
+extern Class StringBuilder_class;
+extern void StringBuilder_init_class();
@@ -1,32 +1,74 @@
 #include "UTF8.h"
 #include "String.h"
 #include "Memory.h"
+#include <string.h>
 
+// ASCII text is skipped eight bytes at a time: a 64-bit word is all ASCII if
+// none of its bytes has the high bit set.  memcpy() lets the words be
+// unaligned, and compiles to a single load.
+#define high_bits 0x8080808080808080ULL
 
-int bytes_in_utf8_character(uint8_t byte)
+static uint64_t load_word(const uint8_t* p)
 {
-	if ((byte & 0x80) == 0)
-		return 1;
+	uint64_t word;
+	memcpy(&word, p, sizeof(word));
+	return word;
+}
 
-	if ((byte & 0xC0) == 0x80 || byte == 0xC0 || byte == 0xC1)
-		return -1;
-	int num_bytes = 1;
-	while (true) {
-		num_bytes += 1;
-		byte <<= 1;
-		if ((byte & 0xC0) == 0x80)
+static const uint8_t* skip_ascii(const uint8_t* p, const uint8_t* end)
+{
+	// Returns a pointer to the first non-ASCII byte, or "end".
+	while (end - p >= 32) {
+		uint64_t words = load_word(p) | load_word(p + 8) | load_word(p + 16) | load_word(p + 24);
+		if (words & high_bits)
 			break;
-		if (byte == 0)
-			return -1;
+		p += 32;
 		}
-	return (num_bytes > 6 ? -1 : num_bytes);
+	while (end - p >= 8) {
+		if (load_word(p) & high_bits)
+			break;
+		p += 8;
+		}
+	while (p < end && *p < 0x80)
+		p += 1;
+	return p;
+}
+
+
+int bytes_in_utf8_character(uint8_t byte)
+{
+	// Continuation bytes (0x80 - 0xBF), 0xC0 and 0xC1 (which could only start
+	// overlong encodings), and 0xFE and 0xFF can't start a character.
+	if (byte < 0x80)
+		return 1;
+	if (byte < 0xC2)
+		return -1;
+	if (byte < 0xE0)
+		return 2;
+	if (byte < 0xF0)
+		return 3;
+	if (byte < 0xF8)
+		return 4;
+	if (byte < 0xFC)
+		return 5;
+	if (byte < 0xFE)
+		return 6;
+	return -1;
 }
 
 
 int bytes_in_n_characters(const char* bytes, int num_characters)
 {
 	int total_bytes = 0;
-	for (; num_characters > 0; --num_characters) {
+	while (num_characters > 0) {
+		// Eight characters need at least eight bytes, so reading a word is safe.
+		if (num_characters >= 8 && (load_word((const uint8_t*) bytes) & high_bits) == 0) {
+			total_bytes += 8;
+			bytes += 8;
+			num_characters -= 8;
+			continue;
+			}
+		num_characters -= 1;
 		int char_bytes = bytes_in_utf8_character(*bytes);
 		if (char_bytes < 0)
 			return -1;
@@ -43,6 +85,12 @@ int chars_in_utf8(const char* bytes_in, int num_bytes)
 	const uint8_t* bytes = (const uint8_t*) bytes_in;
 	const uint8_t* end = bytes + num_bytes;
 	while (bytes < end) {
+		const uint8_t* ascii_end = skip_ascii(bytes, end);
+		total_chars += ascii_end - bytes;
+		bytes = ascii_end;
+		if (bytes >= end)
+			break;
+
 		int char_bytes = bytes_in_utf8_character(*bytes);
 		if (char_bytes < 0)
 			return -1;
@@ -61,9 +109,10 @@ bool is_valid_utf8(const char* bytes, int num_bytes)
 	const uint8_t* end = p + num_bytes;
 	while (p < end) {
 		// Single-byte characters.
+		p = skip_ascii(p, end);
+		if (p >= end)
+			break;
 		uint8_t c = *p++;
-		if ((c & 0x80) == 0)
-			continue;
 
 		// How many bytes?
 		int bytes_left = bytes_in_utf8_character(c) - 1;
@@ -125,6 +174,9 @@ String* decode_8859_1(const uint8_t* bytes, size_t size)
 	const uint8_t* p = bytes;
 	const uint8_t* end = bytes + size;
 	while (p < end) {
+		p = skip_ascii(p, end);
+		if (p >= end)
+			break;
 		uint8_t c = *p++;
 		if (c >= 0x80) {
 			if (c < 0xA0) {
@@ -148,14 +200,19 @@ String* decode_8859_1(const uint8_t* bytes, size_t size)
 		};
 
 	// Decode.
-	char* utf8_bytes = alloc_mem(size + extra_bytes);
+	char* utf8_bytes = alloc_mem(size + extra_bytes + 1);
 	p = bytes;
 	char* out = utf8_bytes;
 	while (p < end) {
+		const uint8_t* ascii_end = skip_ascii(p, end);
+		memcpy(out, p, ascii_end - p);
+		out += ascii_end - p;
+		p = ascii_end;
+		if (p >= end)
+			break;
+
 		uint8_t c = *p++;
-		if (c < 0x80)
-			*out++ = (char) c;
-		else if (c < 0xA0)
+		if (c < 0xA0)
 			out += put_utf8(cp_1252_chars[c - 0x80], out);
 		else
 			out += put_utf8(c, out);
@@ -165,7 +222,11 @@ String* decode_8859_1(const uint8_t* bytes, size_t size)
 	String* result = alloc_obj(String);
 	result->class_ = &String_class;
 	result->str = utf8_bytes;
-	result->size = size + extra_bytes;
+	// The few unassigned Windows-1252 characters come out as a single NUL, so
+	// this can be less than the size we allocated for.
+	result->size = out - utf8_bytes;
+	*out = 0;
+	result->is_c_str = true;
 	return result;
 }
 
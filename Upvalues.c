@@ -3,6 +3,7 @@
 #include "MethodBuilder.h"
 #include "ByteCode.h"
 #include "Object.h"
+#include "Region.h"
 #include "Memory.h"
 
 
@@ -42,7 +43,7 @@ int UpvalueLocal_emit_set(ParseNode* super, ParseNode* value, MethodBuilder* met
 
 UpvalueLocal* new_UpvalueLocal(Method* method, int local_index)
 {
-	UpvalueLocal* self = alloc_obj(UpvalueLocal);
+	UpvalueLocal* self = alloc_compiler_obj(UpvalueLocal);
 	self->parse_node.emit = UpvalueLocal_emit;
 	self->parse_node.emit_set = UpvalueLocal_emit_set;
 	self->method = method;
@@ -5,6 +5,7 @@
 #include "Method.h"
 #include "Environment.h"
 #include "Module.h"
+#include "ByteCodeCache.h"
 #include "Init.h"
 #include "ByteCode.h"
 #include "Object.h"
@@ -18,6 +19,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
+#include <time.h>
+#include <unistd.h>
 
 
 static void lexer_test(const char* file_path)
@@ -25,7 +28,7 @@ static void lexer_test(const char* file_path)
 	// Read the test file.
 	String* contents = file_contents(file_path);
 	if (contents == NULL) {
-		fprintf(stderr, "Couldn't open \"%s\" (%s).", file_path, strerror(errno));
+		fprintf(stderr, "Couldn't open \"%s\" (%s).\n", file_path, strerror(errno));
 		return;
 		}
 
@@ -63,29 +66,162 @@ static void lexer_test(const char* file_path)
 		}
 }
 
+// If $SQS_TIMES is set, the time spent in each phase (in microseconds) and
+// the number of GCs get appended to the file it names.  "bench/startup" uses
+// this.
+
+typedef struct PhaseTimes {
+	long init, load, lex, parse, emit, save, run;
+	} PhaseTimes;
+static PhaseTimes times;
+static struct timespec start_time, phase_start_time;
+
+static long usecs_between(struct timespec* start, struct timespec* end)
+{
+	return (end->tv_sec - start->tv_sec) * 1000000L + (end->tv_nsec - start->tv_nsec) / 1000;
+}
+
+static long phase_time()
+{
+	// Returns the time since the last phase ended.
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	long usecs = usecs_between(&phase_start_time, &now);
+	phase_start_time = now;
+	return usecs;
+}
+
+static void write_times()
+{
+	const char* path = getenv("SQS_TIMES");
+	if (path == NULL || path[0] == 0)
+		return;
+	FILE* file = fopen(path, "a");
+	if (file == NULL)
+		return;
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	fprintf(
+		file, "init=%ld load=%ld lex=%ld parse=%ld emit=%ld save=%ld run=%ld total=%ld gcs=%ld\n",
+		times.init, times.load, times.lex, times.parse, times.emit, times.save, times.run,
+		usecs_between(&start_time, &now), (long) GC_get_gc_no());
+	fclose(file);
+}
+
+
+static bool needs_caching = false;
+static uint64_t script_hash = 0;
+
 static Method* compile_script(const char* file_path)
 {
+	// Sets "needs_caching" if the script was compiled, rather than loaded from
+	// the cache.
+	// Use the cached compilation, if there is one.  (Dumping needs the real
+	// compilation.)
+	if (!dump_requested) {
+		Method* method = ByteCodeCache_load(file_path);
+		times.load = phase_time();
+		if (method)
+			return method;
+		}
+
 	// Read the file.
 	String* contents = file_contents(file_path);
 	if (contents == NULL) {
-		fprintf(stderr, "Couldn't open \"%s\" (%s).", file_path, strerror(errno));
+		fprintf(stderr, "Couldn't open \"%s\" (%s).\n", file_path, strerror(errno));
 		return NULL;
 		}
 
 	Parser* parser = new_Parser(contents->str, contents->size, NULL);
+	if (getenv("SQS_TIMES")) {
+		// The parser normally pulls tokens from the lexer as it goes; lex it all
+		// first, so lexing (and reading the file) can be timed on its own.
+		Lexer_lex_all(parser->lexer);
+		times.lex = phase_time();
+		}
 	ParseNode* ast = Parser_parse_block(parser, NULL);
+	Module_finish_loading();
+	times.parse = phase_time();
 	MethodBuilder* method_builder = new_MethodBuilder(new_Array(), NULL);
 	MethodBuilder_add_literal(method_builder, (Object*) new_c_static_String("main"));
-	ast->emit(ast, method_builder);
+	if (ast) 	// It's NULL if the script is empty.
+		ast->emit(ast, method_builder);
 	MethodBuilder_finish(method_builder);
+	times.emit = phase_time();
+	if (!dump_requested) {
+		needs_caching = true;
+		script_hash = ByteCodeCache_source_hash(contents);
+		}
 	return method_builder->method;
 }
 
 
+static void set_argv(int argc, char* argv[], int first_arg)
+{
+	Array* argv_array = new_Array();
+	for (int i = first_arg; i < argc; ++i)
+		Array_append(argv_array, (Object*) new_c_static_String(argv[i]));
+	GlobalEnvironment_add_c("argv", (Object*) argv_array);
+}
+
+
+static int run_script(Method* method)
+{
+	phase_time();
+	Object* result = call_method(method, NULL);
+	times.run = phase_time();
+	if (result && result->class_ == &Int_class)
+		return Int_value(result);
+
+#ifdef SHOW_NUM_GCS
+	fprintf(stderr, "- Num GCs: %ld\n", GC_get_gc_no());
+#endif
+	return EXIT_SUCCESS;
+}
+
+
+static int bundle_script(int argc, char* argv[], int first_arg)
+{
+	// "sqs --bundle <script> -o <output>".
+	const char* script_path = NULL;
+	const char* output_path = NULL;
+	for (int i = first_arg; i < argc; ++i) {
+		if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+			output_path = argv[++i];
+		else if (script_path == NULL)
+			script_path = argv[i];
+		else
+			Error("Unexpected argument: %s", argv[i]);
+		}
+	if (script_path == NULL || output_path == NULL)
+		Error("Usage: sqs --bundle <script> -o <output>");
+
+	set_argv(1, (char**) &script_path, 0);
+	Method* method = compile_script(script_path);
+	if (method == NULL)
+		return 1;
+	if (!ByteCodeCache_save_bundle(output_path, method))
+		Error("Couldn't write the bundle \"%s\".", output_path);
+	return EXIT_SUCCESS;
+}
+
+
 int main(int argc, char* argv[])
 {
 	// Set up.
+	clock_gettime(CLOCK_MONOTONIC, &start_time);
+	phase_start_time = start_time;
 	init_all();
+	times.init = phase_time();
+
+	// If we're a bundle, just run the bundled script, with all the arguments.
+	set_argv(argc, argv, 0);
+	Method* bundled_method = ByteCodeCache_load_bundle();
+	if (bundled_method) {
+		int result = run_script(bundled_method);
+		write_times();
+		return result;
+		}
 
 	if (argc < 2)
 		return 1;
@@ -95,7 +231,9 @@ int main(int argc, char* argv[])
 	int first_arg = 1;
 	while (first_arg < argc) {
 		const char* arg = argv[first_arg];
-		if (arg[0] == '-') {
+		if (strcmp(arg, "--bundle") == 0)
+			return bundle_script(argc, argv, first_arg + 1);
+		else if (arg[0] == '-') {
 			if (arg[1] == 'd')
 				dump_requested = true;
 			else if (arg[1] == 'l')
@@ -113,25 +251,27 @@ int main(int argc, char* argv[])
 		return 0;
 		}
 
-	// Set up argv.
-	Array* argv_array = new_Array();
-	for (int i = first_arg; i < argc; ++i)
-		Array_append(argv_array, (Object*) new_c_static_String(argv[i]));
-	GlobalEnvironment_add_c("argv", (Object*) argv_array);
-
 	// Compile and run the script.
+	set_argv(argc, argv, first_arg);
 	Method* method = compile_script(argv[first_arg]);
-	if (method) {
-		if (dump_requested)
-			dump_bytecode(method, NULL, new_c_static_String("main"));
-		Object* result = call_method(method, NULL);
-		if (result && result->class_ == &Int_class)
-			return Int_value(result);
-		}
+	if (method == NULL)
+		return EXIT_FAILURE;
+	if (dump_requested)
+		dump_bytecode(method, NULL, new_c_static_String("main"));
+	Method_finish_compiling();
 
-#ifdef SHOW_NUM_GCS
-	fprintf(stderr, "- Num GCs: %ld\n", GC_get_gc_no());
-#endif
-	return EXIT_SUCCESS;
+	// Functions get compiled as they're first called.  Save the cache after the
+	// run, so it's only then that the rest of them get compiled.  The script
+	// might change the working directory, so save from the original one.
+	char* start_dir = (needs_caching ? getcwd(NULL, 0) : NULL);
+	int result = run_script(method);
+	if (needs_caching && start_dir && chdir(start_dir) == 0) {
+		phase_time();
+		ByteCodeCache_save(argv[first_arg], script_hash, method);
+		times.save = phase_time();
+		}
+	free(start_dir);
+	write_times();
+	return result;
 }
 